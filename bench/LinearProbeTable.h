@@ -0,0 +1,86 @@
+#pragma once
+#ifndef LINEARPROBETABLE_H
+#define LINEARPROBETABLE_H
+
+#include "HashTable.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Прежний способ поиска в HashTable - для сравнения в замерах: линейное пробирование
+// по ячейкам, в каждой занятой ячейке на пути - полное сравнение строк.
+// Хеш тоже прежний (многочлен по основанию 31); таблица удваивается при заполнении 3/4.
+class LinearProbeTable {
+private:
+    // Ячейка в прежнем виде: лексема целиком, с собственной строкой
+    struct Entry {
+        TokenType type = TokenType::END_OF_FILE;
+        std::string value;
+        std::int64_t index = -1;
+        bool occupied = false;
+    };
+
+    std::vector<Entry> table;
+    int shift;                  // 64 - log2(размер таблицы)
+    std::int64_t currentIndex;
+
+    static std::uint64_t hashFunction(const std::string& key) {
+        std::uint64_t hash = 0;
+        for (char c : key) hash = hash * 31 + static_cast<unsigned char>(c);
+        return hash * 0x9E3779B97F4A7C15ull;
+    }
+
+    std::size_t findSlot(const std::string& key, double* compares = nullptr) const {
+        std::size_t mask = table.size() - 1;
+        std::size_t index = static_cast<std::size_t>(hashFunction(key) >> shift);
+        while (table[index].occupied) {
+            if (compares) (*compares)++;
+            if (table[index].value == key) break;
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void grow() {
+        std::vector<Entry> old(table.size() * 2);
+        old.swap(table);
+        shift--;
+        for (Entry& entry : old) {
+            if (entry.occupied) table[findSlot(entry.value)] = std::move(entry);
+        }
+    }
+
+public:
+    LinearProbeTable() : table(128), shift(64 - 7), currentIndex(0) {}
+
+    std::int64_t insert(TokenType type, const std::string& value) {
+        std::size_t index = findSlot(value);
+        if (table[index].occupied) return table[index].index;
+        if ((static_cast<std::size_t>(currentIndex) + 1) * 4 > table.size() * 3) {
+            grow();
+            index = findSlot(value);
+        }
+        table[index].type = type;
+        table[index].value = value;
+        table[index].index = currentIndex++;
+        table[index].occupied = true;
+        return table[index].index;
+    }
+
+    std::int64_t find(const std::string& value) const {
+        const Entry& entry = table[findSlot(value)];
+        return entry.occupied ? entry.index : -1;
+    }
+
+    // Среднее число сравнений строк при успешном поиске
+    double averageCompares() const {
+        double compares = 0;
+        for (const Entry& entry : table) {
+            if (entry.occupied) findSlot(entry.value, &compares);
+        }
+        return currentIndex > 0 ? compares / static_cast<double>(currentIndex) : 0;
+    }
+};
+
+#endif
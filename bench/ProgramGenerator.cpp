@@ -0,0 +1,143 @@
+#include "ProgramGenerator.h"
+#include "Keywords.h"
+
+namespace {
+
+const char* const RELATIONS[] = { "=", "<>", ">", "<" };
+const std::size_t NAMES_PER_LINE = 8;  // переменных в одной строке объявления
+
+// Имя из одних букв по номеру: a, b, ..., z, aa, ab, ...
+std::string letterName(std::size_t number) {
+    std::string name;
+    do {
+        name.insert(name.begin(), static_cast<char>('a' + number % 26));
+        number = number / 26;
+    } while (number-- > 0);
+    return name;
+}
+
+}
+
+ProgramGenerator::ProgramGenerator(const GeneratorOptions& generatorOptions)
+    : options(generatorOptions), state(generatorOptions.seed) {
+    if (options.identifiers == 0) options.identifiers = 1;
+
+    // Переменные - имена из букв, кроме совпадающих с ключевыми словами
+    for (std::size_t number = 0; names.size() < options.identifiers; number++) {
+        std::string name = letterName(number);
+        if (lookupKeyword(name.data(), name.size()) == TokenType::ID) {
+            names.push_back(name);
+        }
+    }
+}
+
+std::uint64_t ProgramGenerator::next() {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+std::size_t ProgramGenerator::below(std::size_t bound) {
+    return static_cast<std::size_t>(next() % bound);
+}
+
+bool ProgramGenerator::chance(double probability) {
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0) < probability;
+}
+
+std::string ProgramGenerator::generate() {
+    out.clear();
+    out.reserve(options.targetBytes + 256);
+
+    out += "procedure Generated;\n";
+    writeDeclarations();
+    out += "begin\n";
+    while (out.size() < options.targetBytes) {
+        writeOperator(0, "    ");
+    }
+    out += "end\n";
+    return out;
+}
+
+void ProgramGenerator::writeDeclarations() {
+    out += "var\n";
+    for (std::size_t first = 0; first < names.size(); first += NAMES_PER_LINE) {
+        out += "    ";
+        for (std::size_t i = first; i < names.size() && i < first + NAMES_PER_LINE; i++) {
+            if (i > first) out += ", ";
+            out += names[i];
+        }
+        out += ": integer;\n";
+    }
+}
+
+// Op -> Id := Expr ; | if Condition then Op [else Op]
+void ProgramGenerator::writeOperator(int nesting, const std::string& indent) {
+    if (nesting < 3 && chance(options.ifDensity)) {
+        out += indent;
+        out += "if ";
+        writeCondition();
+        out += " then\n";
+        writeOperator(nesting + 1, indent + "    ");
+        if (chance(options.elseDensity)) {
+            out += indent;
+            out += "else\n";
+            writeOperator(nesting + 1, indent + "    ");
+        }
+        return;
+    }
+    writeAssignment(indent);
+}
+
+void ProgramGenerator::writeAssignment(const std::string& indent) {
+    int error = chance(options.errorRate) ? static_cast<int>(below(3)) : -1;
+
+    out += indent;
+    if (error == 0) {
+        out += "undeclared";   // семантическая ошибка: переменная не объявлена
+    }
+    else if (error == 1) {
+        out += anyName();
+        out += "1";            // лексическая ошибка: цифра в идентификаторе
+    }
+    else {
+        out += anyName();
+    }
+    out += " := ";
+    writeExpr(options.expressionDepth);
+    out += error == 2 ? "\n" : ";\n";  // синтаксическая ошибка: нет ';'
+}
+
+// Condition -> Expr RelationOperator Expr
+void ProgramGenerator::writeCondition() {
+    writeExpr(options.expressionDepth > 0 ? options.expressionDepth - 1 : 0);
+    out += ' ';
+    out += RELATIONS[below(4)];
+    out += ' ';
+    writeExpr(options.expressionDepth > 0 ? options.expressionDepth - 1 : 0);
+}
+
+// Expr -> SimpleExpr | SimpleExpr + Expr | SimpleExpr - Expr
+void ProgramGenerator::writeExpr(int depth) {
+    writeSimpleExpr(depth);
+    for (int terms = 1; terms < 4 && chance(0.5); terms++) {
+        out += chance(0.5) ? " + " : " - ";
+        writeSimpleExpr(depth);
+    }
+}
+
+// SimpleExpr -> Id | Const | ( Expr )
+void ProgramGenerator::writeSimpleExpr(int depth) {
+    if (depth > 0 && chance(0.3)) {
+        out += '(';
+        writeExpr(depth - 1);
+        out += ')';
+    }
+    else if (chance(0.5)) {
+        out += anyName();
+    }
+    else {
+        out += std::to_string(1 + below(99999));  // без ведущих нулей
+    }
+}
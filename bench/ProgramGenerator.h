@@ -0,0 +1,51 @@
+#pragma once
+#ifndef PROGRAMGENERATOR_H
+#define PROGRAMGENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Параметры синтетической программы
+struct GeneratorOptions {
+    std::size_t targetBytes = 1 << 20;  // примерный размер программы в байтах
+    std::size_t identifiers = 64;       // число объявленных переменных
+    int expressionDepth = 3;            // наибольшая вложенность скобок в выражениях
+    double ifDensity = 0.25;            // доля условных операторов среди операторов
+    double elseDensity = 0.5;           // доля условных операторов с веткой else
+    double errorRate = 0.0;             // доля операторов с ошибкой (0 - программа без ошибок)
+    std::uint64_t seed = 1;             // зерно генератора (одинаковое зерно - одинаковая программа)
+};
+
+// Генератор программ на языке лабораторных работ (procedure / var / begin ... end).
+// Программа без ошибок проходит все три анализатора; при errorRate > 0 часть
+// операторов получает ошибку: необъявленную переменную (семантическая),
+// идентификатор с цифрой (лексическая) или пропущенную ';' (синтаксическая).
+// Случайные числа - свой splitmix64, поэтому программа одинакова на всех платформах.
+class ProgramGenerator {
+private:
+    GeneratorOptions options;
+    std::uint64_t state;              // состояние генератора случайных чисел
+    std::vector<std::string> names;   // объявленные переменные
+    std::string out;                  // текст программы
+
+    std::uint64_t next();
+    std::size_t below(std::size_t bound);   // случайное число в [0, bound)
+    bool chance(double probability);
+
+    const std::string& anyName() { return names[below(names.size())]; }
+    void writeDeclarations();
+    void writeOperator(int nesting, const std::string& indent);
+    void writeAssignment(const std::string& indent);
+    void writeCondition();
+    void writeExpr(int depth);
+    void writeSimpleExpr(int depth);
+
+public:
+    explicit ProgramGenerator(const GeneratorOptions& generatorOptions);
+
+    std::string generate();
+};
+
+#endif
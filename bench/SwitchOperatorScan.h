@@ -0,0 +1,40 @@
+#pragma once
+#ifndef SWITCHOPERATORSCAN_H
+#define SWITCHOPERATORSCAN_H
+
+#include "Token.h"
+
+// Прежний разбор операторов (switch по символу, до таблицы переходов OperatorDfa.h) -
+// для сравнения в замерах. Та же сигнатура, что у scanOperator: текст в памяти с '\0'
+// в конце, тип токена - в type, результат - указатель сразу за лексемой.
+inline const char* switchScanOperator(const char* p, TokenType& type) {
+    switch (*p) {
+    case ':':  // может быть : или :=
+        if (p[1] == '=') {
+            type = TokenType::ASSIGN;
+            return p + 2;
+        }
+        type = TokenType::COLON;
+        return p + 1;
+    case ';': type = TokenType::SEMICOLON; return p + 1;
+    case ',': type = TokenType::COMMA; return p + 1;
+    case '(': type = TokenType::LPAREN; return p + 1;
+    case ')': type = TokenType::RPAREN; return p + 1;
+    case '+': type = TokenType::PLUS; return p + 1;
+    case '-': type = TokenType::MINUS; return p + 1;
+    case '=': type = TokenType::EQUAL; return p + 1;
+    case '>': type = TokenType::GREATER; return p + 1;
+    case '<':  // может быть < или <>
+        if (p[1] == '>') {
+            type = TokenType::NOT_EQUAL;
+            return p + 2;
+        }
+        type = TokenType::LESS;
+        return p + 1;
+    default:   // недопустимый символ
+        type = TokenType::ERROR;
+        return p + 1;
+    }
+}
+
+#endif
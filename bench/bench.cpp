@@ -0,0 +1,780 @@
+#include "ProgramGenerator.h"
+#include "Lexer.h"
+#include "HashTable.h"
+#include "LinearProbeTable.h"
+#include "OperatorDfa.h"
+#include "SwitchOperatorScan.h"
+#include "Parser.h"
+#include "SemanticAnalyzer.h"
+#include "OpenHashMap.h"
+#include "Pipeline.h"
+#include "TokenStream.h"
+#include "TokenGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Замеры скорости всех этапов анализа на синтетической программе.
+// Каждый замер повторяется --repeat раз, в отчёт идёт лучший результат.
+// Результаты выводятся в JSON (в stdout или в файл --json).
+
+namespace {
+
+struct Options {
+    GeneratorOptions generator;
+    int repeat = 5;                 // повторов каждого замера
+    std::size_t tableKeys = 2000000;  // лексем в таблице для сравнения способов поиска (0 - не сравнивать)
+    std::size_t symbols = 50000;    // переменных в программе для замера таблиц символов (0 - без замера)
+    unsigned threads = 0;           // потоков для параллельного лексера (0 - по числу ядер)
+    std::string jsonPath;           // файл для результатов (пусто - stdout)
+    std::string emitPath;           // файл для сгенерированной программы (пусто - не сохранять)
+};
+
+void usage() {
+    std::cerr <<
+        "bench [параметры]\n"
+        "  --size N          размер программы в байтах (можно 64K, 16M)\n"
+        "  --identifiers N   число переменных\n"
+        "  --depth N         вложенность скобок в выражениях\n"
+        "  --if P            доля условных операторов (0..1)\n"
+        "  --else P          доля условных операторов с else (0..1)\n"
+        "  --errors P        доля операторов с ошибкой (0..1)\n"
+        "  --seed N          зерно генератора\n"
+        "  --repeat N        повторов каждого замера\n"
+        "  --table-keys N    лексем в таблице для сравнения способов поиска (0 - без сравнения)\n"
+        "  --symbols N       переменных в программе для замера таблиц символов (0 - без замера)\n"
+        "  --threads N       потоков для параллельного лексера\n"
+        "  --json FILE       куда записать результаты (по умолчанию stdout)\n"
+        "  --emit FILE       сохранить сгенерированную программу\n";
+}
+
+// Размер с необязательным суффиксом K или M
+std::size_t parseSize(const char* text) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end == 'K' || *end == 'k') value <<= 10;
+    if (*end == 'M' || *end == 'm') value <<= 20;
+    return static_cast<std::size_t>(value);
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string name = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (name == "--size") options.generator.targetBytes = parseSize(value);
+        else if (name == "--identifiers") options.generator.identifiers = parseSize(value);
+        else if (name == "--depth") options.generator.expressionDepth = std::atoi(value);
+        else if (name == "--if") options.generator.ifDensity = std::atof(value);
+        else if (name == "--else") options.generator.elseDensity = std::atof(value);
+        else if (name == "--errors") options.generator.errorRate = std::atof(value);
+        else if (name == "--seed") options.generator.seed = std::strtoull(value, nullptr, 10);
+        else if (name == "--table-keys") options.tableKeys = parseSize(value);
+        else if (name == "--symbols") options.symbols = parseSize(value);
+        else if (name == "--repeat") options.repeat = std::max(1, std::atoi(value));
+        else if (name == "--threads") options.threads = static_cast<unsigned>(std::atoi(value));
+        else if (name == "--json") options.jsonPath = value;
+        else if (name == "--emit") options.emitPath = value;
+        else return false;
+    }
+    return true;
+}
+
+// Время одного запуска run() в секундах
+template <typename Run>
+double timed(Run run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Лучшее время (в секундах) из repeat запусков run()
+template <typename Run>
+double bestOf(int repeat, Run run) {
+    double best = 0;
+    for (int i = 0; i < repeat; i++) {
+        double seconds = timed(run);
+        if (i == 0 || seconds < best) best = seconds;
+    }
+    return best;
+}
+
+double perSecond(double amount, double seconds) {
+    return seconds > 0 ? amount / seconds : 0;
+}
+
+std::size_t countNodes(const ParseTreeNode* node) {
+    if (!node) return 0;
+    std::size_t count = 1;
+    for (const ParseTreeNode* child : node->children) count += countNodes(child);
+    return count;
+}
+
+// Счётчик промахов предсказания переходов процессора (Linux, perf_event_open).
+// Если счётчики недоступны (другая система, виртуальная машина, запрет perf_event_paranoid),
+// available() = false и в отчёт идёт null
+class BranchMissCounter {
+private:
+    int fd = -1;
+
+public:
+    BranchMissCounter() {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+    ~BranchMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) close(fd);
+#endif
+    }
+    BranchMissCounter(const BranchMissCounter&) = delete;
+    BranchMissCounter& operator=(const BranchMissCounter&) = delete;
+
+    bool available() const { return fd >= 0; }
+
+    // Промахов за время run() (0, если счётчик недоступен)
+    template <typename Run>
+    std::uint64_t count(Run run) {
+        std::uint64_t misses = 0;
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            run();
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &misses, sizeof(misses)) != static_cast<ssize_t>(sizeof(misses))) misses = 0;
+            return misses;
+        }
+#endif
+        run();
+        return misses;
+    }
+};
+
+// Запись JSON вручную: объекты с числовыми полями, порядок полей сохраняется
+class JsonWriter {
+private:
+    std::ostringstream out;
+    bool first = true;          // первое поле текущего объекта
+    int depth = 0;
+
+    void key(const char* name) {
+        out << (first ? "\n" : ",\n") << std::string(depth * 2, ' ') << '"' << name << "\": ";
+        first = false;
+    }
+
+public:
+    JsonWriter() { out << '{'; depth = 1; }
+
+    void begin(const char* name) { key(name); out << '{'; depth++; first = true; }
+    void end() { depth--; out << '\n' << std::string(depth * 2, ' ') << '}'; first = false; }
+    void number(const char* name, double value) {
+        key(name);
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.6g", value);
+        out << text;
+    }
+    void integer(const char* name, unsigned long long value) { key(name); out << value; }
+    void boolean(const char* name, bool value) { key(name); out << (value ? "true" : "false"); }
+    void null(const char* name) { key(name); out << "null"; }
+    void string(const char* name, const std::string& value) { key(name); out << '"' << value << '"'; }
+
+    std::string finish() { out << "\n}\n"; return out.str(); }
+};
+
+// Ключ для замеров хеш-таблиц: лексема и её тип, как их добавляет лексер
+struct TableKey {
+    TokenType type;
+    std::string value;
+};
+
+// count случайных имён из строчных букв длиной 6..13 (first - первая буква, если задана)
+std::vector<std::string> randomNames(std::size_t count, std::uint64_t seed, char first = 0) {
+    std::vector<std::string> names(count);
+    for (std::string& name : names) {
+        std::uint64_t bits = seed += 0x9E3779B97F4A7C15ull;  // splitmix64
+        bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ull;
+        bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBull;
+        bits ^= bits >> 31;
+        std::size_t length = 6 + bits % 8;
+        bits /= 8;
+        for (std::size_t i = 0; i < length; i++) {
+            name += static_cast<char>('a' + bits % 26);
+            bits = i % 8 == 7 ? bits * 0x9E3779B97F4A7C15ull + i : bits / 26;
+        }
+        if (first) name[0] = first;
+    }
+    return names;
+}
+
+// Имена, одинаковые для прежнего хеша (многочлен по основанию 31): "Aa" и "BB" дают
+// одно и то же число, поэтому все 2^blocks склеек из этих пар совпадают по хешу
+std::vector<TableKey> collidingNames(int blocks) {
+    std::vector<TableKey> names;
+    for (std::size_t bits = 0; bits < (std::size_t(1) << blocks); bits++) {
+        std::string name;
+        for (int i = 0; i < blocks; i++) name += (bits >> i) & 1 ? "BB" : "Aa";
+        names.push_back(TableKey{ TokenType::ID, name });
+    }
+    return names;
+}
+
+// Замедление вставки 2^blocks совпадающих имён по сравнению со случайными именами той же длины.
+// Для хеша, устойчивого к подбору коллизий, оно около 1; для прежнего хеша растёт
+// пропорционально числу имён (вставка становится квадратичной).
+template <typename Table>
+double measureFlooding(JsonWriter& json, int repeat, int blocks, std::uint64_t seed) {
+    std::vector<TableKey> colliding = collidingNames(blocks);
+    std::vector<TableKey> random;
+    for (std::string& name : randomNames(colliding.size(), seed)) {
+        name.resize(static_cast<std::size_t>(blocks) * 2, 'q');
+        random.push_back(TableKey{ TokenType::ID, name });
+    }
+    auto insertAll = [repeat](const std::vector<TableKey>& names) {
+        return bestOf(repeat, [&] {
+            Table table;
+            for (const TableKey& key : names) table.insert(key.type, key.value);
+        });
+    };
+    double collidingSeconds = insertAll(colliding);
+    double randomSeconds = insertAll(random);
+    double slowdown = randomSeconds > 0 ? collidingSeconds / randomSeconds : 0;
+
+    json.begin(std::to_string(colliding.size()).c_str());
+    json.number("colliding_inserts_per_second", perSecond(static_cast<double>(colliding.size()), collidingSeconds));
+    json.number("random_inserts_per_second", perSecond(static_cast<double>(random.size()), randomSeconds));
+    json.number("slowdown", slowdown);
+    json.end();
+    return slowdown;
+}
+
+// Заполнение таблицы и поиск присутствующих и отсутствующих имён; результат - успешных поисков в секунду
+template <typename Table>
+double measureTable(JsonWriter& json, const char* name, int repeat, const std::vector<TableKey>& keys,
+    const std::vector<std::string>& misses, Table& table) {
+    double insertSeconds = timed([&] {
+        for (const TableKey& key : keys) table.insert(key.type, key.value);
+    });
+    std::size_t found = 0;
+    double hitSeconds = bestOf(repeat, [&] {
+        found = 0;
+        for (const TableKey& key : keys) found += table.find(key.value) >= 0;
+    });
+    std::size_t wrong = 0;
+    double missSeconds = bestOf(repeat, [&] {
+        wrong = 0;
+        for (const std::string& miss : misses) wrong += table.find(miss) >= 0;
+    });
+    json.begin(name);
+    json.integer("found", found);
+    json.integer("false_hits", wrong);
+    json.number("inserts_per_second", perSecond(static_cast<double>(keys.size()), insertSeconds));
+    json.number("hits_per_second", perSecond(static_cast<double>(keys.size()), hitSeconds));
+    json.number("misses_per_second", perSecond(static_cast<double>(misses.size()), missSeconds));
+    return perSecond(static_cast<double>(keys.size()), hitSeconds);
+}
+
+// Поиск переменной в таблице символов (nullptr - переменной нет)
+const VariableInfo* lookup(const OpenHashMap<VariableInfo>& table, const std::string& name) {
+    return table.find(name);
+}
+const VariableInfo* lookup(const std::unordered_map<std::string, VariableInfo>& table, const std::string& name) {
+    auto found = table.find(name);
+    return found != table.end() ? &found->second : nullptr;
+}
+
+// Обращения семантического анализатора к таблицам символов: объявление каждой
+// переменной (проверка повтора, запись, отметка в множестве объявленных) и каждое
+// использование (поиск типа, отметка в множестве использованных).
+// Результат - число найденных использований.
+template <typename Variables, typename Names>
+std::size_t replaySymbols(const std::vector<std::string>& declared, const std::vector<std::string>& used) {
+    Variables table;
+    Names declaredNames;
+    Names usedNames;
+    for (const std::string& name : declared) {
+        if (lookup(table, name)) continue;  // повторное объявление
+        table[name] = VariableInfo(name, "integer", 0, 0);
+        declaredNames.insert(name);
+    }
+    std::size_t found = 0;
+    for (const std::string& name : used) {
+        if (const VariableInfo* info = lookup(table, name)) {
+            found += !info->type.empty();
+            usedNames.insert(name);
+        }
+    }
+    return found;
+}
+
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    ProgramGenerator generator(options.generator);
+    const std::string program = generator.generate();
+    const double megabytes = static_cast<double>(program.size()) / (1 << 20);
+    if (!options.emitPath.empty()) {
+        std::ofstream(options.emitPath, std::ios::binary) << program;
+    }
+
+    std::ostream discard(nullptr);  // отчёты парсера и анализатора никуда не пишутся
+    JsonWriter json;
+
+    json.begin("program");
+    json.integer("bytes", program.size());
+    json.integer("identifiers", options.generator.identifiers);
+    json.integer("expression_depth", static_cast<unsigned long long>(options.generator.expressionDepth));
+    json.number("if_density", options.generator.ifDensity);
+    json.number("else_density", options.generator.elseDensity);
+    json.number("error_rate", options.generator.errorRate);
+    json.integer("seed", options.generator.seed);
+    json.integer("repeat", static_cast<unsigned long long>(options.repeat));
+    json.end();
+
+    // ЛЕКСЕР: по одному токену через getNextToken()
+    std::size_t tokenCount = 0;
+    std::size_t errorTokens = 0;
+    double seconds = bestOf(options.repeat, [&] {
+        Lexer lexer(program.data(), program.size());
+        std::size_t count = 0;
+        std::size_t errors = 0;
+        TokenType type;
+        do {
+            type = lexer.getNextToken().type();
+            count++;
+            if (type == TokenType::ERROR) errors++;
+        } while (type != TokenType::END_OF_FILE);
+        tokenCount = count;
+        errorTokens = errors;
+    });
+    json.begin("lexer_get_next_token");
+    json.integer("tokens", tokenCount);
+    json.integer("error_tokens", errorTokens);
+    json.number("seconds", seconds);
+    json.number("mb_per_second", perSecond(megabytes, seconds));
+    json.number("tokens_per_second", perSecond(static_cast<double>(tokenCount), seconds));
+    json.end();
+
+    // ЛЕКСЕР: весь вход в буфер токенов, в одном потоке и параллельно
+    for (unsigned threadCount : { 1u, threads }) {
+        seconds = bestOf(options.repeat, [&] {
+            Lexer lexer(program.data(), program.size());
+            tokenCount = lexer.tokenize(threadCount).size();
+        });
+        json.begin(threadCount == 1 ? "lexer_tokenize" : "lexer_tokenize_parallel");
+        json.integer("threads", threadCount);
+        json.number("seconds", seconds);
+        json.number("mb_per_second", perSecond(megabytes, seconds));
+        json.number("tokens_per_second", perSecond(static_cast<double>(tokenCount), seconds));
+        json.end();
+        if (threads == 1) break;
+    }
+
+    // Общие для следующих замеров токены и константы
+    Lexer lexer(program.data(), program.size());
+    TokenBuffer tokens = lexer.tokenize();
+
+    // РАЗБОР ОПЕРАТОРОВ: таблица переходов (OperatorDfa.h, её использует Lexer) против прежнего
+    // switch на всех операторах и разделителях программы в порядке следования
+    std::vector<std::size_t> operatorStarts;
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        TokenType type = tokens.type(i);
+        bool isOperator = type >= TokenType::ASSIGN && type <= TokenType::RPAREN;
+        if (isOperator || tokens.error(i) == LexError::INVALID_CHAR) operatorStarts.push_back(tokens.offset(i));
+    }
+    std::size_t mismatches = 0;
+    for (std::size_t start : operatorStarts) {
+        TokenType dfaType, switchType;
+        const char* dfaEnd = scanOperator(program.c_str() + start, dfaType);
+        const char* switchEnd = switchScanOperator(program.c_str() + start, switchType);
+        if (dfaType != switchType || dfaEnd != switchEnd) mismatches++;
+    }
+    json.begin("operator_scan");
+    json.integer("operators", operatorStarts.size());
+    json.integer("mismatches", mismatches);
+    BranchMissCounter branchMisses;
+    auto measureScan = [&](const char* name, auto scan) {
+        std::size_t checksum = 0;  // чтобы разбор не выбросил оптимизатор
+        auto run = [&] {
+            std::size_t sum = 0;
+            for (std::size_t start : operatorStarts) {
+                TokenType type;
+                const char* end = scan(program.c_str() + start, type);
+                sum += static_cast<std::size_t>(type) + static_cast<std::size_t>(end - program.c_str());
+            }
+            checksum = sum;
+        };
+        double scanSeconds = bestOf(options.repeat, run);
+        std::uint64_t misses = branchMisses.count(run);
+        json.begin(name);
+        json.number("operators_per_second", perSecond(static_cast<double>(operatorStarts.size()), scanSeconds));
+        if (branchMisses.available() && !operatorStarts.empty()) {
+            json.number("branch_misses_per_operator", static_cast<double>(misses) / static_cast<double>(operatorStarts.size()));
+        }
+        else {
+            json.null("branch_misses_per_operator");
+        }
+        json.integer("checksum", checksum);
+        json.end();
+    };
+    measureScan("dfa", [](const char* p, TokenType& type) { return scanOperator(p, type); });
+    measureScan("switch", [](const char* p, TokenType& type) { return switchScanOperator(p, type); });
+    json.end();
+
+    // ХЕШ-ТАБЛИЦА: вставка всех идентификаторов и констант (как в таблице лексем), затем поиск
+    std::vector<TableKey> keys;
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        if (tokens.type(i) == TokenType::ID || tokens.type(i) == TokenType::CONST) {
+            keys.push_back(TableKey{ tokens.type(i), tokens.text(i) });
+        }
+    }
+    std::vector<std::int64_t> indexes(keys.size());
+    double insertSeconds = 0;
+    for (int i = 0; i < options.repeat; i++) {
+        HashTable fresh;
+        double seconds = timed([&] {
+            for (std::size_t k = 0; k < keys.size(); k++) indexes[k] = fresh.insert(keys[k].type, keys[k].value);
+        });
+        if (i == 0 || seconds < insertSeconds) insertSeconds = seconds;
+    }
+    std::size_t stored = 0;    // различных лексем в таблице
+    std::size_t rejected = 0;  // вставок, отвергнутых переполненной таблицей
+    for (std::int64_t index : indexes) {
+        if (index < 0) rejected++;
+        else stored = std::max(stored, static_cast<std::size_t>(index) + 1);
+    }
+    HashTable table;
+    for (const TableKey& key : keys) table.insert(key.type, key.value);
+    std::size_t found = 0;
+    double findSeconds = bestOf(options.repeat, [&] {
+        found = 0;
+        for (const TableKey& key : keys) {
+            if (table.find(key.value) >= 0) found++;
+        }
+    });
+    json.begin("hash_table");
+    json.integer("operations", keys.size());
+    json.integer("stored", stored);
+    json.integer("rejected_inserts", rejected);
+    json.integer("found", found);
+    json.number("insert_seconds", insertSeconds);
+    json.number("inserts_per_second", perSecond(static_cast<double>(keys.size()), insertSeconds));
+    json.number("find_seconds", findSeconds);
+    json.number("finds_per_second", perSecond(static_cast<double>(keys.size()), findSeconds));
+    json.end();
+
+    // СПОСОБЫ ПОИСКА: управляющие байты (HashTable) и прежнее линейное пробирование
+    // на таблице из options.tableKeys случайных имён. Регрессионная проверка: успешный поиск
+    // в HashTable не медленнее прежнего (с запасом ENGINE_TOLERANCE на разброс замеров)
+    const double ENGINE_TOLERANCE = 0.9;
+    bool enginesPassed = true;
+    if (options.tableKeys > 0) {
+        double controlHits = 0;
+        double linearHits = 0;
+        std::vector<TableKey> names;
+        for (std::string& name : randomNames(options.tableKeys, options.generator.seed)) {
+            names.push_back(TableKey{ TokenType::ID, name });
+        }
+        std::vector<std::string> misses = randomNames(options.tableKeys, options.generator.seed + 1, 'Z');
+
+        json.begin("hash_engines");
+        json.integer("keys", names.size());
+        {
+            HashTable table;
+            controlHits = measureTable(json, "control_bytes", options.repeat, names, misses, table);
+            ProbeStats stats = table.probeStats();
+            json.integer("stored", table.size());
+            json.number("groups_per_hit", stats.groups);
+            json.number("compares_per_hit", stats.compares);
+            json.end();
+        }
+        {
+            LinearProbeTable table;
+            linearHits = measureTable(json, "linear_probing", options.repeat, names, misses, table);
+            json.number("compares_per_hit", table.averageCompares());
+            json.end();
+        }
+        enginesPassed = controlHits >= linearHits * ENGINE_TOLERANCE;
+        json.number("hit_speedup", controlHits / linearHits);
+        json.boolean("not_slower", enginesPassed);
+        json.end();
+    }
+
+    // ПОДОБРАННЫЕ КОЛЛИЗИИ (регрессионный тест): вставка имён с одинаковым прежним хешем
+    // в HashTable не должна быть медленнее вставки случайных имён больше чем в FLOOD_LIMIT раз -
+    // ни на маленьком, ни на большом наборе. Прежнее линейное пробирование - для сравнения.
+    const double FLOOD_LIMIT = 2.0;
+    bool floodingPassed = true;
+    json.begin("hash_flooding");
+    json.begin("hash_table");
+    for (int blocks : { 14, 18 }) {
+        double slowdown = measureFlooding<HashTable>(json, std::max(options.repeat, 3), blocks, options.generator.seed);
+        if (slowdown > FLOOD_LIMIT) floodingPassed = false;
+    }
+    json.end();
+    json.begin("linear_probing");
+    measureFlooding<LinearProbeTable>(json, 1, 12, options.generator.seed);
+    json.end();
+    json.boolean("near_linear", floodingPassed);
+    json.end();
+
+    // ПАРСЕР: разбор готового буфера токенов и разбор с лексером по запросу
+    std::size_t nodeCount = 0;
+    bool syntaxErrors = false;
+    seconds = bestOf(options.repeat, [&] {
+        Parser parser(tokens, discard);
+        parser.parseForSemantic();
+        nodeCount = countNodes(parser.getParseTree());
+        syntaxErrors = parser.hasErrors();
+        delete parser.getParseTree();
+    });
+    json.begin("parser_buffer");
+    json.integer("nodes", nodeCount);
+    json.boolean("errors", syntaxErrors);
+    json.number("seconds", seconds);
+    json.number("nodes_per_second", perSecond(static_cast<double>(nodeCount), seconds));
+    json.number("tokens_per_second", perSecond(static_cast<double>(tokens.size()), seconds));
+    json.end();
+
+    seconds = bestOf(options.repeat, [&] {
+        Lexer streamLexer(program.data(), program.size());
+        LexerTokenStream stream(streamLexer);
+        Parser parser(stream, discard);
+        parser.parseForSemantic();
+        delete parser.getParseTree();
+    });
+    json.begin("parser_token_stream");
+    json.number("seconds", seconds);
+    json.number("nodes_per_second", perSecond(static_cast<double>(nodeCount), seconds));
+    json.number("mb_per_second", perSecond(megabytes, seconds));
+    json.end();
+
+    // То же через генератор на сопрограмме (только при сборке как C++20)
+#ifdef TOKEN_COROUTINES
+    const double streamSeconds = seconds;
+    seconds = bestOf(options.repeat, [&] {
+        Lexer generatorLexer(program.data(), program.size());
+        GeneratorTokenStream stream(generatorLexer);
+        Parser parser(stream, discard);
+        parser.parseForSemantic();
+        delete parser.getParseTree();
+    });
+    // Без парсера: только выдача токенов источником - разбор грамматики не заслоняет разницу
+    auto pullAll = [](TokenStream& stream) {
+        while (stream.next().type() != TokenType::END_OF_FILE) {}
+    };
+    const double streamPullSeconds = bestOf(options.repeat, [&] {
+        Lexer pullLexer(program.data(), program.size());
+        LexerTokenStream stream(pullLexer);
+        pullAll(stream);
+    });
+    const double generatorPullSeconds = bestOf(options.repeat, [&] {
+        Lexer pullLexer(program.data(), program.size());
+        GeneratorTokenStream stream(pullLexer);
+        pullAll(stream);
+    });
+    json.begin("parser_coroutine");
+    json.number("seconds", seconds);
+    json.number("nodes_per_second", perSecond(static_cast<double>(nodeCount), seconds));
+    json.number("mb_per_second", perSecond(megabytes, seconds));
+    json.number("slowdown", seconds / streamSeconds);  // во сколько раз медленнее parser_token_stream
+    json.number("pull_seconds", generatorPullSeconds);
+    json.number("token_stream_pull_seconds", streamPullSeconds);
+    json.number("pull_slowdown", generatorPullSeconds / streamPullSeconds);
+    json.end();
+#else
+    json.null("parser_coroutine");
+#endif
+
+    // ПРОХОДЫ ДРАЙВЕРА: прежний драйвер semanticlaba разбирал вход тремя лексерами (таблица
+    // лексем, parse(), parseForSemantic()) и двумя парсерами, нынешний - один лексер и один
+    // парсер по общему буферу. Только работа лексера и парсера, отчёты никуда не пишутся
+    seconds = bestOf(options.repeat, [&] {
+        Lexer tableLexer(program.data(), program.size());
+        TokenBuffer tableTokens = tableLexer.tokenize();
+        for (int pass = 0; pass < 2; pass++) {
+            Lexer passLexer(program.data(), program.size());
+            Parser parser(passLexer, discard);
+            parser.parseForSemantic();
+            delete parser.getParseTree();
+        }
+    });
+    const double threePassSeconds = seconds;
+    seconds = bestOf(options.repeat, [&] {
+        Lexer singleLexer(program.data(), program.size());
+        TokenBuffer singleTokens = singleLexer.tokenize();
+        Parser parser(singleTokens, discard);
+        parser.parseForSemantic();
+        delete parser.getParseTree();
+    });
+    json.begin("driver_passes");
+    json.number("three_lexers_two_parsers_seconds", threePassSeconds);
+    json.number("single_pass_seconds", seconds);
+    json.number("saved", 1 - seconds / threePassSeconds);  // доля сэкономленного времени
+    json.end();
+
+    // СЕМАНТИЧЕСКИЙ АНАЛИЗ: только для дерева без синтаксических ошибок
+    if (syntaxErrors) {
+        json.null("semantic");
+    }
+    else {
+        bool semanticErrors = false;
+        for (int i = 0; i < options.repeat; i++) {
+            Parser parser(tokens, discard);
+            parser.parseForSemantic();
+            ParseTreeNode* tree = parser.getParseTree();
+            SemanticAnalyzer analyzer(discard, &lexer.constants());
+            double analyzeSeconds = timed([&] { analyzer.analyze(tree); });
+            if (i == 0 || analyzeSeconds < seconds) seconds = analyzeSeconds;
+            semanticErrors = analyzer.hasErrors();
+            delete tree;
+        }
+        json.begin("semantic");
+        json.boolean("errors", semanticErrors);
+        json.number("seconds", seconds);
+        json.number("nodes_per_second", perSecond(static_cast<double>(nodeCount), seconds));
+        json.number("mb_per_second", perSecond(megabytes, seconds));
+        json.end();
+    }
+
+    // ТАБЛИЦЫ СИМВОЛОВ: программа с options.symbols переменными; обращения анализатора
+    // к таблицам символов на OpenHashMap и на стандартных контейнерах, затем весь анализ
+    if (options.symbols > 0) {
+        GeneratorOptions symbolOptions = options.generator;
+        symbolOptions.identifiers = options.symbols;
+        symbolOptions.targetBytes = options.symbols * 64;  // в среднем несколько использований на переменную
+        symbolOptions.errorRate = 0;
+        const std::string symbolProgram = ProgramGenerator(symbolOptions).generate();
+
+        // Объявления - идентификаторы между var и begin, остальные (кроме имени процедуры) - использования
+        Lexer symbolLexer(symbolProgram.data(), symbolProgram.size());
+        TokenBuffer symbolTokens = symbolLexer.tokenize();
+        std::vector<std::string> declared;
+        std::vector<std::string> used;
+        bool inDeclarations = false;
+        bool inBody = false;
+        for (std::size_t i = 0; i < symbolTokens.size(); i++) {
+            TokenType type = symbolTokens.type(i);
+            if (type == TokenType::VAR) inDeclarations = true;
+            if (type == TokenType::BEGIN) inDeclarations = false, inBody = true;
+            if (type != TokenType::ID) continue;
+            if (inDeclarations) declared.push_back(symbolTokens.text(i));
+            else if (inBody) used.push_back(symbolTokens.text(i));
+        }
+        const double operations = static_cast<double>(declared.size() + used.size());
+
+        json.begin("symbol_tables");
+        json.integer("bytes", symbolProgram.size());
+        json.integer("declarations", declared.size());
+        json.integer("uses", used.size());
+        std::size_t found = 0;
+        seconds = bestOf(options.repeat, [&] {
+            found = replaySymbols<OpenHashMap<VariableInfo>, OpenHashSet>(declared, used);
+        });
+        json.begin("open_hash_map");
+        json.integer("found", found);
+        json.number("seconds", seconds);
+        json.number("operations_per_second", perSecond(operations, seconds));
+        json.end();
+        seconds = bestOf(options.repeat, [&] {
+            found = replaySymbols<std::unordered_map<std::string, VariableInfo>,
+                std::unordered_set<std::string>>(declared, used);
+        });
+        json.begin("unordered_map");
+        json.integer("found", found);
+        json.number("seconds", seconds);
+        json.number("operations_per_second", perSecond(operations, seconds));
+        json.end();
+
+        bool symbolErrors = false;
+        for (int i = 0; i < options.repeat; i++) {
+            Parser parser(symbolTokens, discard);
+            parser.parseForSemantic();
+            ParseTreeNode* tree = parser.getParseTree();
+            SemanticAnalyzer analyzer(discard, &symbolLexer.constants());
+            double analyzeSeconds = timed([&] { analyzer.analyze(tree); });
+            if (i == 0 || analyzeSeconds < seconds) seconds = analyzeSeconds;
+            symbolErrors = parser.hasErrors() || analyzer.hasErrors();
+            delete tree;
+        }
+        json.begin("semantic");
+        json.boolean("errors", symbolErrors);
+        json.number("seconds", seconds);
+        json.number("mb_per_second", perSecond(static_cast<double>(symbolProgram.size()) / (1 << 20), seconds));
+        json.end();
+        json.end();
+    }
+
+    // ВЕСЬ АНАЛИЗ: последовательно и конвейером. Выигрыш конвейера возможен только на
+    // нескольких ядрах, поэтому вместе с ускорением пишется число аппаратных потоков
+    double sequentialSeconds = 0;
+    for (PipelineMode mode : { PipelineMode::SEQUENTIAL, PipelineMode::PIPELINED }) {
+        seconds = bestOf(options.repeat, [&] {
+            Pipeline pipeline(program, nullptr, nullptr, mode);
+        });
+        json.begin(mode == PipelineMode::SEQUENTIAL ? "pipeline_sequential" : "pipeline_pipelined");
+        json.number("seconds", seconds);
+        json.number("mb_per_second", perSecond(megabytes, seconds));
+        if (mode == PipelineMode::SEQUENTIAL) {
+            sequentialSeconds = seconds;
+        }
+        else {
+            json.number("speedup", sequentialSeconds / seconds);  // > 1 - конвейер быстрее
+            json.integer("hardware_threads", std::thread::hardware_concurrency());
+        }
+        json.end();
+    }
+
+    std::string result = json.finish();
+    if (options.jsonPath.empty()) {
+        std::cout << result;
+    }
+    else {
+        std::ofstream(options.jsonPath) << result;
+    }
+    if (!floodingPassed) {
+        std::cerr << "Вставка подобранных коллизий в HashTable растёт быстрее линейной\n";
+        return 2;
+    }
+    if (!enginesPassed) {
+        std::cerr << "Успешный поиск в HashTable медленнее прежнего линейного пробирования\n";
+        return 3;
+    }
+    return 0;
+}
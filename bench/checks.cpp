@@ -0,0 +1,496 @@
+#include "ProgramGenerator.h"
+#include "CharScan.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include "Pipeline.h"
+#include "StreamSource.h"
+#include "TokenCache.h"
+#include "TokenStream.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Регрессионные проверки, которые не сводятся к замеру скорости.
+// Каждая проверка печатает строку OK или FAIL с пояснением;
+// код возврата - число проваленных проверок.
+
+namespace {
+
+struct Options {
+    std::uint64_t hugeBytes = (std::uint64_t(4) << 30) + (std::uint64_t(64) << 20);  // вход потоковой проверки
+};
+
+void usage() {
+    std::cerr <<
+        "checks [параметры]\n"
+        "  --huge-size N     размер входа для потоковой проверки (можно 64K, 16M, 5G; 0 - пропустить)\n";
+}
+
+// Размер с необязательным суффиксом K, M или G
+std::uint64_t parseSize(const char* text) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (*end == 'K' || *end == 'k') value <<= 10;
+    if (*end == 'M' || *end == 'm') value <<= 20;
+    if (*end == 'G' || *end == 'g') value <<= 30;
+    return value;
+}
+
+bool parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string name = argv[i];
+        if (i + 1 >= argc) return false;
+        const char* value = argv[++i];
+        if (name == "--huge-size") options.hugeBytes = parseSize(value);
+        else return false;
+    }
+    return true;
+}
+
+int failures = 0;
+
+void report(bool passed, const std::string& name, const std::string& details) {
+    std::cout << (passed ? "OK   " : "FAIL ") << name << ": " << details << std::endl;
+    if (!passed) failures++;
+}
+
+// Канал: байты, записанные в writeEnd, читаются из readEnd
+bool openPipe(int& readEnd, int& writeEnd) {
+    int fds[2];
+#ifdef _WIN32
+    if (_pipe(fds, 1 << 16, _O_BINARY) != 0) return false;
+#else
+    if (::pipe(fds) != 0) return false;
+#endif
+    readEnd = fds[0];
+    writeEnd = fds[1];
+    return true;
+}
+
+bool writeAll(int fd, std::string_view bytes) {
+    while (!bytes.empty()) {
+#ifdef _WIN32
+        int count = _write(fd, bytes.data(), static_cast<unsigned>(std::min<std::size_t>(bytes.size(), 1 << 30)));
+#else
+        ssize_t count = ::write(fd, bytes.data(), bytes.size());
+#endif
+        if (count <= 0) return false;
+        bytes.remove_prefix(static_cast<std::size_t>(count));
+    }
+    return true;
+}
+
+void closeFd(int fd) {
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+// Смещение, строка и позиция токена
+struct TokenPlace {
+    std::uint64_t offset = 0;
+    std::int64_t line = 0;
+    std::int64_t position = 0;
+};
+
+// Токены куска текста (без END_OF_FILE), место последнего токена и END_OF_FILE
+struct TextTokens {
+    std::uint64_t count = 0;
+    TokenPlace last;
+    TokenPlace end;
+};
+
+TokenPlace placeOf(const Token& token, SourceLocation where) {
+    TokenPlace place;
+    place.offset = token.offset();
+    place.line = where.line;
+    place.position = where.position;
+    return place;
+}
+
+TextTokens lexText(std::string_view text) {
+    TextTokens result;
+    Lexer lexer(text.data(), text.size());
+    for (Token token = lexer.getNextToken(); ; token = lexer.getNextToken()) {
+        if (token.type() == TokenType::END_OF_FILE) {
+            result.end = placeOf(token, lexer.location(token));
+            return result;
+        }
+        result.count++;
+        result.last = placeOf(token, lexer.location(token));
+    }
+}
+
+// Источник токенов, запоминающий число токенов, место последнего токена и END_OF_FILE
+class CountingTokenStream : public TokenStream {
+private:
+    TokenStream& source;
+
+public:
+    std::uint64_t count = 0;    // токенов до END_OF_FILE
+    std::uint64_t errors = 0;   // из них ошибочных
+    TokenPlace last;
+    TokenPlace end;
+
+    explicit CountingTokenStream(TokenStream& inner) : source(inner) {}
+
+    Token next() override {
+        Token token = source.next();
+        if (token.type() == TokenType::END_OF_FILE) {
+            end = placeOf(token, source.location());
+        }
+        else {
+            count++;
+            if (token.type() == TokenType::ERROR) errors++;
+            last = placeOf(token, source.location());
+        }
+        return token;
+    }
+
+    SourceLocation location() const override { return source.location(); }
+    std::string_view text() override { return source.text(); }
+};
+
+// Вход больше 4 ГБ через канал: заголовок и объявления программы, затем её операторы
+// много раз подряд и "end". Лексер читает поток окнами, парсер разбирает токены
+// по мере чтения и не хранит операторы - память не зависит от длины входа.
+// Число токенов, смещения, строки и позиции последнего токена и конца входа
+// сравниваются с рассчитанными по одному экземпляру текста.
+void checkHugeStream(std::uint64_t targetBytes) {
+    GeneratorOptions generatorOptions;
+    generatorOptions.targetBytes = 1 << 20;
+    const std::string program = ProgramGenerator(generatorOptions).generate();
+    const std::size_t bodyStart = program.find("\nbegin\n") + 7;
+    const std::size_t bodyEnd = program.size() - 4;  // перед "end\n"
+    const std::string_view head(program.data(), bodyStart);
+    const std::string_view body(program.data() + bodyStart, bodyEnd - bodyStart);
+    const std::string_view tail(program.data() + bodyEnd, program.size() - bodyEnd);
+
+    const std::uint64_t fixed = head.size() + tail.size();
+    const std::uint64_t repeats = targetBytes > fixed ? (targetBytes - fixed + body.size() - 1) / body.size() : 1;
+    const std::uint64_t totalBytes = fixed + repeats * body.size();
+
+    // Ожидаемые значения: весь текст с одним экземпляром операторов, сдвинутый на repeats - 1 экземпляров
+    std::uint64_t bodyLines = 0;
+    for (char c : body) bodyLines += c == '\n';
+    const std::uint64_t extraBytes = (repeats - 1) * body.size();
+    const std::uint64_t extraLines = (repeats - 1) * bodyLines;
+    const TextTokens single = lexText(program);
+    const std::uint64_t expectedCount = single.count + (repeats - 1) * lexText(body).count;
+
+    int readEnd = -1;
+    int writeEnd = -1;
+    if (!openPipe(readEnd, writeEnd)) {
+        report(false, "huge_stream", "не удалось создать канал");
+        return;
+    }
+    std::thread writer([&]() {
+        bool written = writeAll(writeEnd, head);
+        for (std::uint64_t i = 0; written && i < repeats; i++) {
+            written = writeAll(writeEnd, body);
+        }
+        if (written) writeAll(writeEnd, tail);
+        closeFd(writeEnd);
+    });
+
+    Lexer lexer(readEnd, std::string());
+    LexerTokenStream lexerStream(lexer);
+    CountingTokenStream stream(lexerStream);
+    std::ostream discard(nullptr);
+    Parser parser(stream, discard);
+    parser.setKeepOperators(false);  // операторы удаляются сразу после разбора
+    parser.parseForSemantic();
+    delete parser.getParseTree();
+    writer.join();
+    closeFd(readEnd);
+
+    bool passed = stream.count == expectedCount && stream.errors == 0 && !parser.hasErrors()
+        && stream.last.offset == single.last.offset + extraBytes
+        && stream.last.line == single.last.line + static_cast<std::int64_t>(extraLines)
+        && stream.last.position == single.last.position
+        && stream.end.offset == totalBytes
+        && stream.end.line == single.end.line + static_cast<std::int64_t>(extraLines)
+        && stream.end.position == single.end.position;
+    report(passed, "huge_stream",
+        std::to_string(totalBytes) + " байт, " + std::to_string(stream.count) + " токенов (ожидалось "
+        + std::to_string(expectedCount) + "), конец входа: строка " + std::to_string(stream.end.line)
+        + " (ожидалась " + std::to_string(single.end.line + static_cast<std::int64_t>(extraLines))
+        + "), смещение " + std::to_string(stream.end.offset)
+        + (parser.hasErrors() ? ", синтаксические ошибки" : ""));
+}
+
+// reader получает дескриптор канала, в который другой поток пишет text
+template <typename Reader>
+bool readThroughPipe(std::string_view text, Reader reader) {
+    int readEnd = -1;
+    int writeEnd = -1;
+    if (!openPipe(readEnd, writeEnd)) return false;
+    std::thread writer([&]() {
+        writeAll(writeEnd, text);
+        closeFd(writeEnd);
+    });
+    reader(readEnd);
+    writer.join();
+    closeFd(readEnd);
+    return true;
+}
+
+// Вход без переводов строк (и вход вовсе без пробельных символов) через канал:
+// окна потока режутся на границах лексем, буфер не растёт сверх одного блока,
+// а токены - тип, смещение, длина, номер, строка, позиция и текст - те же, что у
+// лексера по тому же тексту в памяти
+void checkLongLineStream() {
+    GeneratorOptions generatorOptions;
+    generatorOptions.targetBytes = 4 << 20;
+    const std::string program = ProgramGenerator(generatorOptions).generate();
+
+    std::string oneLine = program;
+    std::replace(oneLine.begin(), oneLine.end(), '\n', ' ');
+    std::string noSpaces;
+    for (char c : program) {
+        if (!isSpaceChar(c)) noSpaces += c;
+    }
+
+    for (const std::string* text : { &oneLine, &noSpaces }) {
+        const char* name = text == &oneLine ? "long_line_stream" : "no_space_stream";
+
+        // Память: размер буфера потока по всем окнам
+        std::size_t maxCapacity = 0;
+        std::uint64_t windows = 0;
+        bool piped = readThroughPipe(*text, [&](int fd) {
+            StreamSource source(fd);
+            std::size_t consumed = 0;
+            while (source.next(consumed)) {
+                maxCapacity = std::max(maxCapacity, source.capacity());
+                consumed = static_cast<std::size_t>(source.end() - source.begin());
+                windows++;
+            }
+        });
+
+        // Токены потока против токенов того же текста в памяти
+        std::uint64_t count = 0;
+        std::uint64_t mismatches = 0;
+        piped = piped && readThroughPipe(*text, [&](int fd) {
+            Lexer stream(fd, std::string());
+            Lexer memory(text->data(), text->size());
+            for (;;) {
+                Token actual = stream.getNextToken();
+                Token expected = memory.getNextToken();
+                SourceLocation actualWhere = stream.location(actual);
+                SourceLocation expectedWhere = memory.location(expected);
+                if (actual.type() != expected.type() || actual.offset() != expected.offset()
+                    || actual.length != expected.length || actual.id != expected.id
+                    || actualWhere.line != expectedWhere.line || actualWhere.position != expectedWhere.position
+                    || stream.lexeme(actual) != memory.lexeme(expected)) {
+                    mismatches++;
+                }
+                count++;
+                if (expected.type() == TokenType::END_OF_FILE || actual.type() == TokenType::END_OF_FILE) break;
+            }
+        });
+
+        bool passed = piped && mismatches == 0 && maxCapacity == StreamSource::BLOCK_SIZE;
+        report(passed, name,
+            std::to_string(text->size()) + " байт, " + std::to_string(windows) + " окон, буфер до "
+            + std::to_string(maxCapacity) + " байт, " + std::to_string(count) + " токенов, расхождений: "
+            + std::to_string(mismatches) + (piped ? "" : ", не удалось создать канал"));
+    }
+}
+
+// Маски структурного прохода (SSE2 или AVX2 - что выбрано при запуске) совпадают
+// с посимвольной классификацией по таблице на случайных блоках из всех 256 значений байта
+// и из символов языка; лексер по маскам на тех же байтах находит те же границы серий
+void checkBlockMasks() {
+    std::mt19937_64 random(20241017);
+    const char alphabet[] = " \t\r\nabzAZ09_:;,()+-=<>*\x80\xC1\xFF";
+    std::string bytes(BLOCK_BYTES * 4096, '\0');
+    for (std::size_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = (i / BLOCK_BYTES) % 2 == 0 ? static_cast<char>(random())
+            : alphabet[random() % (sizeof(alphabet) - 1)];
+    }
+
+    std::size_t mismatches = 0;
+    for (std::size_t start = 0; start + BLOCK_BYTES <= bytes.size(); start += BLOCK_BYTES) {
+        BlockMasks fast = classifyBlock(bytes.data() + start, BLOCK_BYTES);
+        BlockMasks slow = classifyBlockScalar(bytes.data() + start, BLOCK_BYTES);
+        if (fast.space != slow.space || fast.letter != slow.letter || fast.digit != slow.digit || fast.op != slow.op) {
+            mismatches++;
+        }
+    }
+
+    // Серии со всех позиций: границы по маскам против посимвольного поиска
+    BlockScanner scanner;
+    const char* end = bytes.data() + bytes.size();
+    scanner.reset(end);
+    for (const char* p = bytes.data(); p < end; p += 7) {
+        const char* spaces = p;
+        while (spaces < end && isSpaceChar(*spaces)) ++spaces;
+        const char* alnum = p;
+        while (alnum < end && isAlnumChar(*alnum)) ++alnum;
+        if (scanner.skipSpaces(p) != spaces || scanner.skipAlnum(p) != alnum) {
+            mismatches++;
+        }
+    }
+
+    report(mismatches == 0, "block_masks",
+        std::to_string(bytes.size() / BLOCK_BYTES) + " блоков, расхождений: " + std::to_string(mismatches));
+}
+
+// Совпадение буферов поле за полем (текст сравнивается через смещение и длину)
+bool sameTokens(const TokenBuffer& expected, const TokenBuffer& actual) {
+    if (expected.size() != actual.size()) return false;
+    for (std::size_t i = 0; i < expected.size(); i++) {
+        if (expected.type(i) != actual.type(i) || expected.offset(i) != actual.offset(i)
+            || expected.length(i) != actual.length(i) || expected.error(i) != actual.error(i)
+            || expected.id(i) != actual.id(i) || expected.line(i) != actual.line(i)
+            || expected.position(i) != actual.position(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Конвейер и последовательный анализ дают одно и то же: токены (поле за полем),
+// сообщения об ошибках всех этапов и постфиксную запись
+void checkPipelineModes(double errorRate) {
+    GeneratorOptions generatorOptions;
+    generatorOptions.targetBytes = 256 << 10;
+    generatorOptions.errorRate = errorRate;
+    const std::string program = ProgramGenerator(generatorOptions).generate();
+
+    Pipeline sequential(program, nullptr, nullptr, PipelineMode::SEQUENTIAL);
+    Pipeline pipelined(program, nullptr, nullptr, PipelineMode::PIPELINED);
+    const TokenBuffer& expected = sequential.getTokens();
+    const TokenBuffer& actual = pipelined.getTokens();
+
+    bool tokensMatch = sameTokens(expected, actual);
+    bool passed = tokensMatch
+        && sequential.getLexicalErrors() == pipelined.getLexicalErrors()
+        && sequential.getSyntaxErrors() == pipelined.getSyntaxErrors()
+        && sequential.getSemanticErrors() == pipelined.getSemanticErrors()
+        && sequential.semanticAnalyzed() == pipelined.semanticAnalyzed()
+        && sequential.getPostfixCode() == pipelined.getPostfixCode();
+    report(passed, "pipeline_modes",
+        "доля ошибок " + std::to_string(errorRate) + ", " + std::to_string(expected.size()) + " токенов"
+        + (tokensMatch ? "" : ", токены различаются"));
+}
+
+// Два входа одного размера, различающиеся старшим битом 7-го и 15-го байтов: у прежнего
+// ключа кэша (FNV по 8-байтовым словам) эти правки сокращались и второй вход получал
+// токены первого. Кэш, записанный для первого входа, не должен подойти второму.
+// Входы - не меньше TokenCache::MIN_SOURCE_SIZE, иначе кэш не пишется вовсе
+void checkCacheCollision() {
+    GeneratorOptions generatorOptions;
+    generatorOptions.targetBytes = TokenCache::MIN_SOURCE_SIZE;
+    const std::string first = ProgramGenerator(generatorOptions).generate();
+    std::string second = first;
+    second[7] = static_cast<char>(second[7] ^ 0x80);
+    second[15] = static_cast<char>(second[15] ^ 0x80);
+
+    const std::string firstPath = "checks_cache_first.txt";
+    const std::string secondPath = "checks_cache_second.txt";
+    const std::string cachePath = "checks_cache.tok";
+    std::ofstream(firstPath, std::ios::binary) << first;
+    std::ofstream(secondPath, std::ios::binary) << second;
+    std::remove(cachePath.c_str());
+
+    Lexer(firstPath, std::string()).tokenizeCached(cachePath);  // кэш первого входа
+    Lexer cachedLexer(secondPath, std::string());
+    TokenBuffer cached = cachedLexer.tokenizeCached(cachePath);
+    Lexer plainLexer(secondPath, std::string());
+    TokenBuffer plain = plainLexer.tokenize();
+
+    bool keysDiffer = TokenCache::hashBytes(first.data(), first.data() + first.size())
+        != TokenCache::hashBytes(second.data(), second.data() + second.size());
+    bool tokensMatch = sameTokens(plain, cached);
+    report(keysDiffer && tokensMatch, "cache_collision",
+        std::string(keysDiffer ? "ключи различаются" : "ключи совпали")
+        + (tokensMatch ? ", токены второго входа разобраны заново" : ", второй вход получил чужие токены"));
+
+    std::remove(firstPath.c_str());
+    std::remove(secondPath.c_str());
+    std::remove(cachePath.c_str());
+}
+
+// Токены, константы и имена из кэша совпадают с разбором того же входа; файл кэша
+// не больше двух байтов на байт входа. Маленький вход не кэшируется
+void checkCacheRoundTrip() {
+    GeneratorOptions generatorOptions;
+    generatorOptions.targetBytes = 4 << 20;
+    const std::string text = ProgramGenerator(generatorOptions).generate();
+    const std::string inputPath = "checks_cache_input.txt";
+    const std::string cachePath = "checks_cache.tok";
+    std::ofstream(inputPath, std::ios::binary) << text;
+    std::remove(cachePath.c_str());
+
+    Lexer(inputPath, std::string()).tokenizeCached(cachePath);  // запись кэша
+    std::ifstream written(cachePath, std::ios::binary | std::ios::ate);
+    std::uint64_t cacheSize = written.is_open() ? static_cast<std::uint64_t>(written.tellg()) : 0;
+    written.close();
+
+    Lexer cachedLexer(inputPath, std::string());
+    TokenBuffer cached = cachedLexer.tokenizeCached(cachePath);
+    Lexer plainLexer(inputPath, std::string());
+    TokenBuffer plain = plainLexer.tokenize();
+
+    bool tokensMatch = sameTokens(plain, cached);
+    bool poolsMatch = cachedLexer.constants().size() == plainLexer.constants().size()
+        && cachedLexer.symbols().size() == plainLexer.symbols().size();
+    for (std::size_t k = 0; poolsMatch && k < plainLexer.constants().size(); k++) {
+        poolsMatch = cachedLexer.constants().value(k) == plainLexer.constants().value(k);
+    }
+    for (std::size_t k = 0; poolsMatch && k < plainLexer.symbols().size(); k++) {
+        poolsMatch = cachedLexer.symbols().key(k) == plainLexer.symbols().key(k);
+    }
+    bool compact = cacheSize > 0 && cacheSize <= 2 * text.size();
+
+    std::remove(cachePath.c_str());
+    std::ofstream(inputPath, std::ios::binary | std::ios::trunc) << text.substr(0, 4 << 10);
+    Lexer(inputPath, std::string()).tokenizeCached(cachePath);
+    bool smallSkipped = !std::ifstream(cachePath).is_open();
+
+    report(tokensMatch && poolsMatch && compact && smallSkipped, "cache_round_trip",
+        "кэш " + std::to_string(cacheSize) + " байт на " + std::to_string(text.size()) + " байт входа"
+        + (tokensMatch ? "" : ", токены различаются") + (poolsMatch ? "" : ", константы или имена различаются")
+        + (smallSkipped ? "" : ", маленький вход закэширован"));
+
+    std::remove(inputPath.c_str());
+    std::remove(cachePath.c_str());
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    checkBlockMasks();
+    checkPipelineModes(0.0);
+    checkPipelineModes(0.05);
+    checkCacheCollision();
+    checkCacheRoundTrip();
+    checkLongLineStream();
+    if (options.hugeBytes > 0) {
+        checkHugeStream(options.hugeBytes);
+    }
+    return failures;
+}
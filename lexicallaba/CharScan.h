@@ -0,0 +1,381 @@
+#pragma once
+#ifndef CHARSCAN_H
+#define CHARSCAN_H
+
+// Поиск границ лексем: структурный проход по блокам из 64 байт (маски пробелов, букв,
+// цифр и символов операторов) и поиск переводов строк.
+// Классы символов задаются таблицей CHAR_CLASSES: они совпадают с <cctype> в локали "C",
+// но не зависят от локали и корректны для отрицательных значений char (байты CP1251).
+// На x86 блок проверяется по 16 байт за раз (SSE2), а если процессор поддерживает AVX2 -
+// по 32 байта; наличие AVX2 проверяется при запуске, так что сборка не требует -mavx2.
+// На остальных платформах - посимвольно.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CHARSCAN_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Функции с 32-байтовыми командами компилируются для AVX2 отдельно от остального кода
+#ifdef CHARSCAN_SSE2
+#if defined(__GNUC__) || defined(__clang__)
+#define CHARSCAN_AVX2 1
+#define CHARSCAN_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER)
+#define CHARSCAN_AVX2 1
+#define CHARSCAN_AVX2_TARGET
+#include <immintrin.h>
+#endif
+#endif
+
+#include <cstddef>
+#include <cstdint>
+
+// Класс символа для лексера. Каждый байт относится ровно к одному классу.
+enum class CharClass : unsigned char {
+    OTHER,       // недопустимый символ (в том числе все байты >= 0x80)
+    END,         // '\0' - конец входных данных
+    SPACE,       // пробел, \t, \n, \v, \f, \r
+    LETTER,      // A-Z, a-z
+    DIGIT,       // 0-9
+    UNDERSCORE,  // _
+    COLON, SEMICOLON, COMMA, LPAREN, RPAREN,
+    PLUS, MINUS, EQUAL, GREATER, LESS,
+    COUNT        // число классов (размер строк таблиц переходов)
+};
+
+// Таблица классов на все 256 значений байта, заполняется при компиляции
+struct CharClassTable {
+    CharClass cls[256];
+};
+
+constexpr CharClassTable buildCharClasses() {
+    CharClassTable table{};
+    for (int c = 0; c < 256; c++) table.cls[c] = CharClass::OTHER;
+    table.cls[0] = CharClass::END;
+    table.cls[static_cast<unsigned char>(' ')] = CharClass::SPACE;
+    for (int c = '\t'; c <= '\r'; c++) table.cls[c] = CharClass::SPACE;
+    for (int c = 'a'; c <= 'z'; c++) table.cls[c] = CharClass::LETTER;
+    for (int c = 'A'; c <= 'Z'; c++) table.cls[c] = CharClass::LETTER;
+    for (int c = '0'; c <= '9'; c++) table.cls[c] = CharClass::DIGIT;
+    table.cls[static_cast<unsigned char>('_')] = CharClass::UNDERSCORE;
+    table.cls[static_cast<unsigned char>(':')] = CharClass::COLON;
+    table.cls[static_cast<unsigned char>(';')] = CharClass::SEMICOLON;
+    table.cls[static_cast<unsigned char>(',')] = CharClass::COMMA;
+    table.cls[static_cast<unsigned char>('(')] = CharClass::LPAREN;
+    table.cls[static_cast<unsigned char>(')')] = CharClass::RPAREN;
+    table.cls[static_cast<unsigned char>('+')] = CharClass::PLUS;
+    table.cls[static_cast<unsigned char>('-')] = CharClass::MINUS;
+    table.cls[static_cast<unsigned char>('=')] = CharClass::EQUAL;
+    table.cls[static_cast<unsigned char>('>')] = CharClass::GREATER;
+    table.cls[static_cast<unsigned char>('<')] = CharClass::LESS;
+    return table;
+}
+
+constexpr CharClassTable CHAR_CLASSES = buildCharClasses();
+
+// Класс символа - одно обращение к таблице, без локали и без ветвлений
+inline CharClass charClass(char c) { return CHAR_CLASSES.cls[static_cast<unsigned char>(c)]; }
+
+inline bool isSpaceChar(char c) { return charClass(c) == CharClass::SPACE; }
+inline bool isLetterChar(char c) { return charClass(c) == CharClass::LETTER; }
+inline bool isDigitChar(char c) { return charClass(c) == CharClass::DIGIT; }
+inline bool isAlnumChar(char c) { CharClass k = charClass(c); return k == CharClass::LETTER || k == CharClass::DIGIT; }
+
+#ifdef CHARSCAN_SSE2
+
+// Номер младшего установленного бита (mask != 0)
+inline int lowestBit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Маска байтов в диапазоне [lo, hi] (сравнения знаковые, байты >= 0x80 в диапазон не попадают)
+inline __m128i rangeMask(__m128i bytes, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(static_cast<char>(lo - 1))),
+        _mm_cmplt_epi8(bytes, _mm_set1_epi8(static_cast<char>(hi + 1))));
+}
+
+#endif
+
+#ifdef CHARSCAN_AVX2
+
+// Поддерживает ли процессор AVX2 (и сохраняет ли ОС 32-байтовые регистры)
+inline bool detectAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0;
+    return osxsave && avx2 && (_xgetbv(0) & 6) == 6;
+#endif
+}
+
+// Определяется при статической инициализации; до неё равно false и работает путь SSE2
+inline const bool CHARSCAN_HAS_AVX2 = detectAvx2();
+
+CHARSCAN_AVX2_TARGET inline __m256i rangeMask(__m256i bytes, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), bytes));
+}
+
+#endif
+
+// Классы символов для структурного прохода: проверка 16 и 32 байт сразу (SSE2 и AVX2)
+struct SpaceClass {
+#ifdef CHARSCAN_SSE2
+    static __m128i mask(__m128i bytes) {
+        return _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), rangeMask(bytes, '\t', '\r'));
+    }
+#endif
+#ifdef CHARSCAN_AVX2
+    CHARSCAN_AVX2_TARGET static __m256i mask(__m256i bytes) {
+        return _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), rangeMask(bytes, '\t', '\r'));
+    }
+#endif
+};
+
+struct LetterClass {
+#ifdef CHARSCAN_SSE2
+    static __m128i mask(__m128i bytes) {
+        return rangeMask(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), 'a', 'z');  // 0x20 переводит A-Z в a-z
+    }
+#endif
+#ifdef CHARSCAN_AVX2
+    CHARSCAN_AVX2_TARGET static __m256i mask(__m256i bytes) {
+        return rangeMask(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), 'a', 'z');
+    }
+#endif
+};
+
+struct DigitClass {
+#ifdef CHARSCAN_SSE2
+    static __m128i mask(__m128i bytes) { return rangeMask(bytes, '0', '9'); }
+#endif
+#ifdef CHARSCAN_AVX2
+    CHARSCAN_AVX2_TARGET static __m256i mask(__m256i bytes) { return rangeMask(bytes, '0', '9'); }
+#endif
+};
+
+// Символы операторов и разделителей: ( ) + , - : ; < = > - три диапазона кодов
+struct OperatorClass {
+#ifdef CHARSCAN_SSE2
+    static __m128i mask(__m128i bytes) {
+        return _mm_or_si128(_mm_or_si128(rangeMask(bytes, '(', ')'), rangeMask(bytes, '+', '-')),
+            rangeMask(bytes, ':', '>'));
+    }
+#endif
+#ifdef CHARSCAN_AVX2
+    CHARSCAN_AVX2_TARGET static __m256i mask(__m256i bytes) {
+        return _mm256_or_si256(_mm256_or_si256(rangeMask(bytes, '(', ')'), rangeMask(bytes, '+', '-')),
+            rangeMask(bytes, ':', '>'));
+    }
+#endif
+};
+
+// Номер младшего установленного бита 64-битной маски (mask != 0)
+inline int lowestBit64(std::uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Структурный проход (как в simdjson): вход делится на блоки по BLOCK_BYTES байт,
+// каждый блок проверяется один раз и даёт по 64-битной маске на класс - i-й бит
+// относится к i-му байту блока. Байт входит не больше чем в один класс; '\0',
+// '_' и недопустимые символы - ни в один, байты за концом входа - тоже.
+struct BlockMasks {
+    std::uint64_t space;    // пробельные символы
+    std::uint64_t letter;   // буквы
+    std::uint64_t digit;    // цифры
+    std::uint64_t op;       // символы операторов и разделителей
+};
+
+const std::size_t BLOCK_BYTES = 64;
+
+// Маски первых count <= BLOCK_BYTES байт по таблице классов (хвост входа и платформы без SSE2)
+inline BlockMasks classifyBlockScalar(const char* p, std::size_t count) {
+    BlockMasks masks = { 0, 0, 0, 0 };
+    for (std::size_t i = 0; i < count; i++) {
+        CharClass k = charClass(p[i]);
+        masks.space |= static_cast<std::uint64_t>(k == CharClass::SPACE) << i;
+        masks.letter |= static_cast<std::uint64_t>(k == CharClass::LETTER) << i;
+        masks.digit |= static_cast<std::uint64_t>(k == CharClass::DIGIT) << i;
+        masks.op |= static_cast<std::uint64_t>(k >= CharClass::COLON && k <= CharClass::LESS) << i;
+    }
+    return masks;
+}
+
+#ifdef CHARSCAN_SSE2
+
+// Маски полного блока: четыре куска по 16 байт
+inline BlockMasks classifyBlockSse2(const char* p) {
+    BlockMasks masks = { 0, 0, 0, 0 };
+    for (int k = 0; k < 4; k++) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+        masks.space |= static_cast<std::uint64_t>(_mm_movemask_epi8(SpaceClass::mask(bytes))) << (16 * k);
+        masks.letter |= static_cast<std::uint64_t>(_mm_movemask_epi8(LetterClass::mask(bytes))) << (16 * k);
+        masks.digit |= static_cast<std::uint64_t>(_mm_movemask_epi8(DigitClass::mask(bytes))) << (16 * k);
+        masks.op |= static_cast<std::uint64_t>(_mm_movemask_epi8(OperatorClass::mask(bytes))) << (16 * k);
+    }
+    return masks;
+}
+
+#endif
+
+#ifdef CHARSCAN_AVX2
+
+// Маска 32 байт из movemask (без расширения знака старшего бита)
+CHARSCAN_AVX2_TARGET inline std::uint64_t movemask32(__m256i mask) {
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(mask));
+}
+
+// Маски полного блока: два куска по 32 байта
+CHARSCAN_AVX2_TARGET inline BlockMasks classifyBlockAvx2(const char* p) {
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    BlockMasks masks;
+    masks.space = movemask32(SpaceClass::mask(low)) | movemask32(SpaceClass::mask(high)) << 32;
+    masks.letter = movemask32(LetterClass::mask(low)) | movemask32(LetterClass::mask(high)) << 32;
+    masks.digit = movemask32(DigitClass::mask(low)) | movemask32(DigitClass::mask(high)) << 32;
+    masks.op = movemask32(OperatorClass::mask(low)) | movemask32(OperatorClass::mask(high)) << 32;
+    return masks;
+}
+
+// Вызов visit для каждого байта c в полных 32-байтовых блоках; возвращает начало остатка
+template <typename Visit>
+CHARSCAN_AVX2_TARGET const char* forEachByteAvx2(const char* p, const char* end, char c, Visit& visit) {
+    const __m256i pattern = _mm256_set1_epi8(c);
+    while (end - p >= 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned found = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, pattern)));
+        while (found != 0) {
+            visit(p + lowestBit(found));
+            found &= found - 1;
+        }
+        p += 32;
+    }
+    return p;
+}
+
+#endif
+
+// Маски блока из count байт, начиная с p (count < BLOCK_BYTES - последний блок входа)
+inline BlockMasks classifyBlock(const char* p, std::size_t count) {
+    if (count < BLOCK_BYTES) {
+        return classifyBlockScalar(p, count);
+    }
+#ifdef CHARSCAN_AVX2
+    if (CHARSCAN_HAS_AVX2) return classifyBlockAvx2(p);
+#endif
+#ifdef CHARSCAN_SSE2
+    return classifyBlockSse2(p);
+#else
+    return classifyBlockScalar(p, count);
+#endif
+}
+
+// Потребитель масок: лексер спрашивает класс байта и конец серии байтов одного
+// класса, а сканер отвечает по маскам текущего блока - сдвигом и подсчётом младших
+// нулей, не читая байты заново. Блок классифицируется, когда лексер впервые
+// заходит в него; следующий блок начинается сразу за текущим.
+class BlockScanner {
+private:
+    const char* blockStart;  // начало текущего блока (nullptr - блок не загружен)
+    const char* end;         // конец входа
+    BlockMasks masks;        // маски текущего блока
+
+    // Номер байта p в текущем блоке; если p вне блока, блок начинается с p
+    unsigned offsetOf(const char* p) {
+        if (p < blockStart || p - blockStart >= static_cast<std::ptrdiff_t>(BLOCK_BYTES) || !blockStart) {
+            blockStart = p;
+            std::size_t left = static_cast<std::size_t>(end - p);
+            masks = classifyBlock(p, left < BLOCK_BYTES ? left : BLOCK_BYTES);
+        }
+        return static_cast<unsigned>(p - blockStart);
+    }
+
+    // Первый байт в [p, end), не входящий в классы, отобранные select (или end).
+    // Биты за концом входа нулевые, поэтому серия всегда обрывается на end.
+    template <typename Select>
+    const char* skip(const char* p, Select select) {
+        for (;;) {
+            unsigned offset = offsetOf(p);
+            std::uint64_t outside = ~select(masks) >> offset;
+            if (outside != 0) {
+                return p + lowestBit64(outside);
+            }
+            p = blockStart + BLOCK_BYTES;  // серия идёт до конца блока - продолжаем в следующем
+        }
+    }
+
+public:
+    BlockScanner() : blockStart(nullptr), end(nullptr), masks() {}
+
+    // Новые входные байты, заканчивающиеся в inputEnd (старые маски больше не годятся)
+    void reset(const char* inputEnd) {
+        blockStart = nullptr;
+        end = inputEnd;
+    }
+
+    // Маски блока с байтом p и бит этого байта в них
+    const BlockMasks& masksAt(const char* p, std::uint64_t& bit) {
+        bit = std::uint64_t(1) << offsetOf(p);
+        return masks;
+    }
+
+    const char* skipSpaces(const char* p) { return skip(p, [](const BlockMasks& m) { return m.space; }); }
+    const char* skipLetters(const char* p) { return skip(p, [](const BlockMasks& m) { return m.letter; }); }
+    const char* skipDigits(const char* p) { return skip(p, [](const BlockMasks& m) { return m.digit; }); }
+    const char* skipAlnum(const char* p) { return skip(p, [](const BlockMasks& m) { return m.letter | m.digit; }); }
+};
+
+// Вызов visit(указатель) для каждого байта c в [p, end) по порядку
+template <typename Visit>
+inline void forEachByte(const char* p, const char* end, char c, Visit visit) {
+#ifdef CHARSCAN_AVX2
+    if (CHARSCAN_HAS_AVX2) p = forEachByteAvx2(p, end, c, visit);
+#endif
+#ifdef CHARSCAN_SSE2
+    const __m128i pattern = _mm_set1_epi8(c);
+    while (end - p >= 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned found = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, pattern)));
+        while (found != 0) {
+            visit(p + lowestBit(found));
+            found &= found - 1;  // снимаем младший бит
+        }
+        p += 16;
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == c) visit(p);
+    }
+}
+
+#endif
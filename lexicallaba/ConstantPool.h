@@ -0,0 +1,37 @@
+#pragma once
+#ifndef CONSTANTPOOL_H
+#define CONSTANTPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Пул целочисленных констант программы. Лексер переводит число в значение
+// один раз, одинаковые константы хранятся один раз, а токены и узлы дерева
+// ссылаются на них по индексу (32 бита: констант не больше 2^32).
+// Индекс по значению - плоская таблица с открытой адресацией и линейным
+// пробированием. Ячейка хранит только 4-байтовый индекс, а значение берётся из
+// values: таблица вчетверо меньше, чем с парой (значение, индекс), и на больших
+// программах вместе с values помещается в кэш L2 - поиск не уходит в память.
+class ConstantPool {
+private:
+    static const std::uint32_t EMPTY = UINT32_MAX;  // свободная ячейка
+    static const int INITIAL_BITS = 6;  // начальный размер таблицы - 2^6 ячеек
+
+    std::vector<std::int64_t> values;   // значения в порядке первого появления
+    std::vector<std::uint32_t> slots;   // таблица индексов в values (размер - степень двойки, заполнена не больше чем наполовину)
+    int shift;                          // 64 - log2(размер таблицы): старшие биты хеша дают номер ячейки
+
+    std::size_t slotOf(std::int64_t value) const;  // ячейка со значением или первая свободная
+    void rebuild(int bits);                        // таблица на 2^bits ячеек
+
+public:
+    ConstantPool();
+
+    std::uint32_t intern(std::int64_t value);      // индекс значения (добавляется, если его нет)
+    std::int64_t value(std::size_t index) const { return values[index]; }
+    std::size_t size() const { return values.size(); }
+    void reserve(std::size_t expected);            // место под expected констант без перестроек таблицы
+};
+
+#endif
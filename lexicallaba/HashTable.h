@@ -1,35 +1,34 @@
-#pragma once
-#ifndef HASHTABLE_H
-#define HASHTABLE_H
-
-#include "Token.h"
-#include <string>
-
-struct HashEntry {
-    Token token;    //  
-    int index;      //   
-    bool occupied;  //  -   
-
-    HashEntry() : token(), index(-1), occupied(false) {}
-};
-
-class HashTable {
-private:
-    static const int TABLE_SIZE = 100;  //   
-    HashEntry* table;                   //   
-    int currentIndex;                   //   
-
-    //  :
-    int hashFunction(const std::string& key);      //  
-    int findEmptySlot(const std::string& key);     //   
-
-public:
-    HashTable();                        // 
-    ~HashTable();                       // 
-
-    int insert(const Token& token);     //  
-    int find(const std::string& value); //    
-    void printToFile(const std::string& filename); //    
-};
-
-#endif
\ No newline at end of file
+#pragma once
+#ifndef HASHTABLE_H
+#define HASHTABLE_H
+
+#include "Token.h"
+#include "OutputSink.h"
+#include "OpenHashMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Хеш-таблица лексем: текст лексемы - ключ, тип - значение (OpenHashMap).
+// Индекс лексемы - номер в порядке добавления, в этом же порядке таблица выводится.
+class HashTable {
+private:
+    OpenHashMap<TokenType> lexemes;     // лексемы и их типы
+
+public:
+    HashTable() {}                      // конструктор (зерно хеша - случайное на запуск)
+    explicit HashTable(std::uint64_t hashSeed) : lexemes(hashSeed) {}  // конструктор с заданным зерном хеша
+
+    std::int64_t insert(TokenType type, std::string_view value);  // добавление лексемы
+    std::int64_t find(std::string_view value) const;              // поиск лексемы по значению
+    std::size_t size() const { return lexemes.size(); }           // число лексем
+
+    // Лексемы по индексу
+    TokenType type(std::size_t index) const { return lexemes.value(index); }
+    std::string_view text(std::size_t index) const { return lexemes.key(index); }
+
+    ProbeStats probeStats() const { return lexemes.probeStats(); }  // затраты поиска (для замеров)
+    void writeTo(OutputSink& out);      // вывод таблицы в выходной файл (в порядке индексов)
+};
+
+#endif
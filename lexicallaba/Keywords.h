@@ -0,0 +1,123 @@
+#pragma once
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include "Token.h"
+#include <cstddef>
+#include <cstring>
+
+// Описание типа токена: имя для вывода и написание ключевого слова (nullptr - не ключевое слово)
+struct TokenTypeInfo {
+    TokenType type;
+    const char* name;
+    const char* keyword;
+};
+
+// Единая таблица типов токенов в порядке перечисления TokenType.
+// Из неё строятся и вывод типов, и распознавание ключевых слов:
+// новое ключевое слово - это значение в TokenType и строка здесь.
+constexpr TokenTypeInfo TOKEN_TYPES[] = {
+    { TokenType::PROCEDURE,   "PROCEDURE",   "procedure" },
+    { TokenType::BEGIN,       "BEGIN",       "begin" },
+    { TokenType::END,         "END",         "end" },
+    { TokenType::VAR,         "VAR",         "var" },
+    { TokenType::INTEGER,     "INTEGER",     "integer" },
+    { TokenType::IF,          "IF",          "if" },
+    { TokenType::THEN,        "THEN",        "then" },
+    { TokenType::ELSE,        "ELSE",        "else" },
+    { TokenType::ID,          "ID",          nullptr },
+    { TokenType::CONST,       "CONST",       nullptr },
+    { TokenType::ASSIGN,      "ASSIGN",      nullptr },
+    { TokenType::PLUS,        "PLUS",        nullptr },
+    { TokenType::MINUS,       "MINUS",       nullptr },
+    { TokenType::EQUAL,       "EQUAL",       nullptr },
+    { TokenType::NOT_EQUAL,   "NOT_EQUAL",   nullptr },
+    { TokenType::GREATER,     "GREATER",     nullptr },
+    { TokenType::LESS,        "LESS",        nullptr },
+    { TokenType::SEMICOLON,   "SEMICOLON",   nullptr },
+    { TokenType::COLON,       "COLON",       nullptr },
+    { TokenType::COMMA,       "COMMA",       nullptr },
+    { TokenType::LPAREN,      "LPAREN",      nullptr },
+    { TokenType::RPAREN,      "RPAREN",      nullptr },
+    { TokenType::END_OF_FILE, "END_OF_FILE", nullptr },
+    { TokenType::ERROR,       "ERROR",       nullptr },
+};
+
+constexpr std::size_t TOKEN_TYPE_COUNT = sizeof(TOKEN_TYPES) / sizeof(TOKEN_TYPES[0]);
+
+// Проверка, что строки таблицы идут в порядке перечисления
+constexpr bool tokenTableOrdered() {
+    for (std::size_t i = 0; i < TOKEN_TYPE_COUNT; i++) {
+        if (static_cast<std::size_t>(TOKEN_TYPES[i].type) != i) return false;
+    }
+    return true;
+}
+static_assert(tokenTableOrdered(), "TOKEN_TYPES должна идти в порядке TokenType");
+static_assert(TOKEN_TYPE_COUNT == static_cast<std::size_t>(TokenType::ERROR) + 1, "в TOKEN_TYPES описаны не все типы");
+
+// Имя типа токена для вывода
+inline const char* tokenTypeName(TokenType type) {
+    std::size_t index = static_cast<std::size_t>(type);
+    return index < TOKEN_TYPE_COUNT ? TOKEN_TYPES[index].name : "UNKNOWN";
+}
+
+// ---- Совершенный хеш ключевых слов, построенный при компиляции ----
+
+constexpr std::size_t KEYWORD_SLOTS = 16;  // размер таблицы (степень двойки)
+
+constexpr std::size_t constLength(const char* s) {
+    std::size_t length = 0;
+    while (s[length] != '\0') length++;
+    return length;
+}
+
+// Хеш по первому и последнему символу и длине: одна операция на слово
+constexpr std::size_t keywordHash(const char* s, std::size_t length, unsigned seed) {
+    return (static_cast<unsigned char>(s[0]) * seed + static_cast<unsigned char>(s[length - 1]) + length)
+        & (KEYWORD_SLOTS - 1);
+}
+
+// Ячейки хеш-таблицы: индекс строки TOKEN_TYPES или -1
+struct KeywordSlots {
+    int slot[KEYWORD_SLOTS];
+    bool perfect;  // все ключевые слова попали в разные ячейки
+};
+
+constexpr KeywordSlots buildKeywordSlots(unsigned seed) {
+    KeywordSlots result{};
+    result.perfect = true;
+    for (std::size_t i = 0; i < KEYWORD_SLOTS; i++) result.slot[i] = -1;
+    for (std::size_t i = 0; i < TOKEN_TYPE_COUNT; i++) {
+        const char* keyword = TOKEN_TYPES[i].keyword;
+        if (!keyword) continue;
+        std::size_t h = keywordHash(keyword, constLength(keyword), seed);
+        if (result.slot[h] != -1) result.perfect = false;
+        result.slot[h] = static_cast<int>(i);
+    }
+    return result;
+}
+
+// Подбор множителя, при котором хеш совершенный
+constexpr unsigned findKeywordSeed() {
+    for (unsigned seed = 1; seed < 256; seed++) {
+        if (buildKeywordSlots(seed).perfect) return seed;
+    }
+    return 0;
+}
+
+constexpr unsigned KEYWORD_SEED = findKeywordSeed();
+static_assert(KEYWORD_SEED != 0, "не найден совершенный хеш ключевых слов - увеличьте KEYWORD_SLOTS");
+constexpr KeywordSlots KEYWORD_TABLE = buildKeywordSlots(KEYWORD_SEED);
+
+// Тип слова: ключевое слово или ID. Один хеш и одно сравнение.
+inline TokenType lookupKeyword(const char* text, std::size_t length) {
+    int row = KEYWORD_TABLE.slot[keywordHash(text, length, KEYWORD_SEED)];
+    if (row < 0) return TokenType::ID;
+    const char* keyword = TOKEN_TYPES[row].keyword;
+    if (std::strncmp(keyword, text, length) == 0 && keyword[length] == '\0') {
+        return TOKEN_TYPES[row].type;
+    }
+    return TokenType::ID;
+}
+
+#endif
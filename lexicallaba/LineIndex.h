@@ -0,0 +1,54 @@
+#pragma once
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Место в исходном тексте в том виде, в каком оно выводится
+struct SourceLocation {
+    std::int64_t line;       // номер строки (с 1)
+    std::int64_t position;   // позиция в строке
+};
+
+// Строка и позиция по номеру строки (с 0) и смещению от её начала
+// (atEnd - смещение указывает на конец входа)
+SourceLocation makeLocation(std::size_t row, std::size_t column, bool atEnd);
+
+// Индекс начал строк: лексер хранит только смещения байтов,
+// а строка и позиция вычисляются по смещению при выводе (двоичным поиском).
+class LineIndex {
+private:
+    std::vector<std::size_t> lineStarts;  // смещения начал строк (первая строка - смещение 0)
+    std::size_t size;                     // размер входных данных в байтах
+
+public:
+    LineIndex() : lineStarts(1, 0), size(0) {}
+    LineIndex(const char* begin, const char* end);  // построение по входным байтам
+
+    std::size_t lineCount() const { return lineStarts.size(); }  // число строк
+    // Правка входа: байты [offset, offset + removed) заменены на inserted (длины insertedLength)
+    void update(std::size_t offset, std::size_t removed, const char* inserted, std::size_t insertedLength);
+    SourceLocation locate(std::size_t offset) const;             // строка и позиция по смещению
+};
+
+// Счётчик строк для потокового входа: смещения идут только вперёд,
+// поэтому хранится лишь начало текущей строки, а не все строки
+class LineCounter {
+private:
+    std::size_t row;         // номер текущей строки (с 0)
+    std::size_t lineStart;   // смещение её начала
+
+public:
+    LineCounter() : row(0), lineStart(0) {}
+
+    // Учёт переводов строк в байтах [begin, end), begin имеет смещение beginOffset
+    void scan(const char* begin, const char* end, std::size_t beginOffset);
+    // Место смещения offset на текущей строке (atEnd - конец входа)
+    SourceLocation locate(std::size_t offset, bool atEnd) const {
+        return makeLocation(row, offset - lineStart, atEnd);
+    }
+};
+
+#endif
@@ -0,0 +1,282 @@
+#pragma once
+#ifndef OPENHASHMAP_H
+#define OPENHASHMAP_H
+
+#include "CharScan.h"
+#include "StringHash.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Средние затраты успешного поиска по всем ключам таблицы
+struct ProbeStats {
+    double groups;      // просмотренных групп управляющих байтов
+    double compares;    // полных сравнений строк
+};
+
+// Значение для множества строк (OpenHashSet)
+struct NoValue {};
+
+// Хеш-таблица со строковыми ключами и открытой адресацией. Тексты ключей лежат
+// подряд в блоках памяти, которые не перемещаются: вид key(i) действителен, пока
+// жива таблица. Записи (ключ и значение) - в плотном массиве в порядке добавления;
+// номер записи в нём - индекс ключа, он не меняется при росте таблицы.
+// Индекс состоит из 16-байтовых ячеек (хеш и номер записи) и массива управляющих
+// байтов: EMPTY для свободной ячейки или 7 бит хеша ключа. Поиск проверяет
+// 16 управляющих байтов сразу (SSE2), сравнивает полный хеш в ячейке и только
+// при его совпадении читает запись и текст ключа. Ключей - не больше 2^32.
+// Искать можно по std::string_view - ключ для поиска не копируется в std::string.
+// Удаления нет: ключи только добавляются.
+template <typename Value>
+class OpenHashMap {
+public:
+    // Запись таблицы: место текста ключа в буфере ключей и значение
+    struct Entry {
+        const char* text;       // текст ключа (в блоке ключей)
+        std::uint64_t length;   // длина текста
+        Value value;
+    };
+
+    static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);  // ключа нет в таблице
+
+private:
+    // Ячейка индекса: четыре на строку кэша. Место и длина текста берутся из записи,
+    // к которой поиск обращается, только если совпал весь хеш
+    struct Slot {
+        std::uint64_t hash;     // хеш ключа (при росте таблицы не вычисляется заново)
+        std::uint32_t index;    // номер записи
+    };
+
+    static const int INITIAL_BITS = 7;  // начальный размер индекса - 2^7 ячеек (размер всегда степень двойки)
+    // Наибольшая заполненность MAX_LOAD_NUM / MAX_LOAD_DEN: при превышении индекс удваивается
+    static const std::size_t MAX_LOAD_NUM = 7;
+    static const std::size_t MAX_LOAD_DEN = 8;
+    static const std::size_t GROUP = 16;        // управляющих байтов, проверяемых за раз
+    static constexpr signed char EMPTY = -128;  // управляющий байт свободной ячейки (занятая - 0..127)
+    static const std::size_t ARENA_BLOCK = 1 << 16;  // размер блока текстов ключей (длинный ключ - в своём блоке)
+
+    std::vector<std::unique_ptr<char[]>> arena;  // блоки текстов ключей
+    char* arenaFree;                    // свободное место в последнем блоке
+    std::size_t arenaLeft;              // сколько его осталось
+    std::vector<Entry> entries;         // записи в порядке добавления (номер = индекс)
+    std::vector<Slot> slots;            // ячейки индекса
+    // Управляющие байты ячеек; за последним повторены первые GROUP байтов,
+    // чтобы группа у конца индекса читалась одним куском
+    std::vector<signed char> controls;
+    int shift;                          // 64 - log2(размер индекса): старшие биты хеша дают номер ячейки
+    std::uint64_t seed;                 // зерно хеша
+
+    // Биты результата: i-й бит установлен, если i-й байт группы равен control
+    static unsigned matchControl(const signed char* group, signed char control) {
+#ifdef CHARSCAN_SSE2
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(control))));
+#else
+        unsigned mask = 0;
+        for (int i = 0; i < 16; i++) {
+            if (group[i] == control) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // Номер младшего установленного бита (mask != 0)
+    static int firstBit(unsigned mask) {
+#ifdef CHARSCAN_SSE2
+        return lowestBit(mask);
+#else
+        int bit = 0;
+        while (!(mask & 1u)) {
+            mask >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    std::uint64_t hashFunction(std::string_view key) const {
+        return hashString(key.data(), key.size(), seed);
+    }
+
+    // Управляющий байт занятой ячейки - 7 бит хеша сразу за битами номера ячейки
+    signed char tagOf(std::uint64_t hash) const {
+        return static_cast<signed char>((hash >> (shift - 7)) & 0x7F);
+    }
+
+    // Поиск ячейки с ключом или первой свободной ячейки. Группы по GROUP ячеек
+    // просматриваются подряд с начальной; ключ может быть только до первой свободной
+    // ячейки, поэтому проверяются лишь ячейки до неё с совпавшими 7 битами хеша,
+    // а строки сравниваются, только если совпал и весь хеш.
+    // Индекс никогда не заполняется целиком, поэтому свободная ячейка всегда найдётся.
+    std::size_t findSlot(std::string_view key, std::uint64_t hash, ProbeStats* stats = nullptr) const {
+        std::size_t mask = slots.size() - 1;
+        std::size_t pos = static_cast<std::size_t>(hash >> shift);  // начальная ячейка - старшие биты хеша
+        signed char tag = tagOf(hash);
+#ifdef CHARSCAN_SSE2
+        // Ключ почти всегда в начальной ячейке: её чтение идёт одновременно с проверкой управляющих байтов
+        _mm_prefetch(reinterpret_cast<const char*>(&slots[pos]), _MM_HINT_T0);
+#endif
+
+        while (true) {
+            const signed char* group = controls.data() + pos;
+            unsigned empty = matchControl(group, EMPTY);
+            unsigned candidates = matchControl(group, tag);
+            if (empty != 0) {
+                candidates &= (empty & (0u - empty)) - 1;  // только ячейки до первой свободной
+            }
+            if (stats) stats->groups++;
+
+            while (candidates != 0) {
+                std::size_t index = (pos + firstBit(candidates)) & mask;
+                const Slot& slot = slots[index];
+                if (slot.hash == hash) {
+                    const Entry& entry = entries[slot.index];
+                    if (stats) stats->compares++;
+                    if (entry.length == key.size()
+                        && std::memcmp(entry.text, key.data(), key.size()) == 0) {
+                        return index;
+                    }
+                }
+                candidates &= candidates - 1;  // снимаем младший бит
+            }
+            if (empty != 0) {
+                return (pos + firstBit(empty)) & mask;
+            }
+            pos = (pos + GROUP) & mask;  // переходим к следующей группе
+        }
+    }
+
+    // Управляющий байт ячейки (и его копия за концом индекса)
+    void setControl(std::size_t index, signed char control) {
+        controls[index] = control;
+        if (index < GROUP) {
+            controls[slots.size() + index] = control;
+        }
+    }
+
+    // Удвоение индекса: ячейки переносятся по сохранённому хешу (строки не читаются
+    // и не сравниваются - все ключи разные), индексы ключей не меняются
+    void grow() {
+        std::vector<Slot> oldSlots(slots.size() * 2);
+        std::vector<signed char> oldControls(oldSlots.size() + GROUP, EMPTY);
+        oldSlots.swap(slots);
+        oldControls.swap(controls);
+        shift--;
+
+        std::size_t mask = slots.size() - 1;
+        for (std::size_t i = 0; i < oldSlots.size(); i++) {
+            if (oldControls[i] == EMPTY) continue;
+            const Slot& slot = oldSlots[i];
+            std::size_t index = static_cast<std::size_t>(slot.hash >> shift);
+            while (controls[index] != EMPTY) {
+                index = (index + 1) & mask;  // первая свободная ячейка
+            }
+            setControl(index, tagOf(slot.hash));
+            slots[index] = slot;
+        }
+    }
+
+    // Копия текста ключа в блоке ключей; уже занятые блоки не перемещаются
+    const char* storeText(std::string_view key) {
+        if (key.size() > arenaLeft) {
+            std::size_t size = key.size() > ARENA_BLOCK ? key.size() : ARENA_BLOCK;
+            arena.emplace_back(new char[size]);
+            arenaFree = arena.back().get();
+            arenaLeft = size;
+        }
+        char* text = arenaFree;
+        if (!key.empty()) std::memcpy(text, key.data(), key.size());
+        arenaFree += key.size();
+        arenaLeft -= key.size();
+        return text;
+    }
+
+public:
+    OpenHashMap() : OpenHashMap(runHashSeed()) {}  // зерно хеша - случайное на запуск
+
+    explicit OpenHashMap(std::uint64_t hashSeed)
+        : arenaFree(nullptr), arenaLeft(0), slots(std::size_t(1) << INITIAL_BITS), controls((std::size_t(1) << INITIAL_BITS) + GROUP, EMPTY),
+        shift(64 - INITIAL_BITS), seed(hashSeed) {
+    }
+
+    std::size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    // Добавление ключа со значением, если ключа ещё нет (иначе значение не меняется).
+    // Результат - индекс ключа и признак того, что ключ добавлен сейчас.
+    std::pair<std::size_t, bool> insert(std::string_view key, const Value& value = Value()) {
+        std::uint64_t hash = hashFunction(key);
+        std::size_t index = findSlot(key, hash);
+        if (controls[index] != EMPTY) {
+            return std::make_pair(slots[index].index, false);  // ключ уже есть
+        }
+
+        // Новый ключ: если индекс станет слишком заполненным, сначала увеличиваем его
+        if (entries.size() > UINT32_MAX) {
+            throw std::length_error("OpenHashMap: больше 2^32 ключей");
+        }
+        if ((entries.size() + 1) * MAX_LOAD_DEN > slots.size() * MAX_LOAD_NUM) {
+            grow();
+            index = findSlot(key, hash);
+        }
+
+        Entry entry = { storeText(key), key.size(), value };
+        slots[index] = { hash, static_cast<std::uint32_t>(entries.size()) };
+        setControl(index, tagOf(hash));
+        entries.push_back(std::move(entry));
+        return std::make_pair(slots[index].index, true);
+    }
+
+    // Значение по ключу; ключ без значения добавляется со значением Value()
+    Value& operator[](std::string_view key) { return entries[insert(key).first].value; }
+
+    // Индекс ключа (NPOS - ключа нет)
+    std::size_t indexOf(std::string_view key) const {
+        std::size_t index = findSlot(key, hashFunction(key));
+        return controls[index] != EMPTY ? slots[index].index : NPOS;
+    }
+
+    bool contains(std::string_view key) const { return indexOf(key) != NPOS; }
+
+    // Значение по ключу (nullptr - ключа нет)
+    Value* find(std::string_view key) {
+        std::size_t index = indexOf(key);
+        return index != NPOS ? &entries[index].value : nullptr;
+    }
+    const Value* find(std::string_view key) const {
+        std::size_t index = indexOf(key);
+        return index != NPOS ? &entries[index].value : nullptr;
+    }
+
+    // Ключи и значения по индексу (индексы идут подряд с 0 в порядке добавления)
+    std::string_view key(std::size_t index) const {
+        return std::string_view(entries[index].text, static_cast<std::size_t>(entries[index].length));
+    }
+    Value& value(std::size_t index) { return entries[index].value; }
+    const Value& value(std::size_t index) const { return entries[index].value; }
+
+    // Затраты поиска (для замеров; обходит всю таблицу)
+    ProbeStats probeStats() const {
+        ProbeStats stats = { 0, 0 };
+        for (std::size_t i = 0; i < entries.size(); i++) {
+            std::string_view text = key(i);
+            findSlot(text, hashFunction(text), &stats);
+        }
+        if (!entries.empty()) {
+            stats.groups /= static_cast<double>(entries.size());
+            stats.compares /= static_cast<double>(entries.size());
+        }
+        return stats;
+    }
+};
+
+// Множество строк
+using OpenHashSet = OpenHashMap<NoValue>;
+
+#endif
@@ -0,0 +1,77 @@
+#pragma once
+#ifndef OPERATORDFA_H
+#define OPERATORDFA_H
+
+#include "Token.h"
+#include "CharScan.h"
+
+// Автомат разбора операторов и разделителей (Lexer::parseOperator): таблица переходов
+// по классам символов из CharScan.h, строится при компиляции.
+
+// Состояния автомата разбора операторов
+enum class OperatorState : unsigned char { START, AFTER_COLON, AFTER_LESS, COUNT };
+
+// Переход автомата: либо в следующее состояние, либо выдача токена (с поглощением символа или без)
+struct OperatorTransition {
+    OperatorState next;  // следующее состояние (если токен не выдаётся)
+    bool emit;           // выдать токен
+    bool consume;        // поглотить текущий символ
+    TokenType type;      // тип выдаваемого токена
+};
+
+struct OperatorDfa {
+    OperatorTransition step[static_cast<int>(OperatorState::COUNT)][static_cast<int>(CharClass::COUNT)];
+};
+
+constexpr OperatorTransition dfaGoTo(OperatorState next) { return { next, false, true, TokenType::ERROR }; }
+constexpr OperatorTransition dfaTake(TokenType type) { return { OperatorState::START, true, true, type }; }
+constexpr OperatorTransition dfaStop(TokenType type) { return { OperatorState::START, true, false, type }; }
+
+// Таблица переходов: ':' и '<' ждут второго символа (':=' и '<>'), остальное - односимвольные токены
+constexpr OperatorDfa buildOperatorDfa() {
+    OperatorDfa dfa{};
+    const int start = static_cast<int>(OperatorState::START);
+    const int afterColon = static_cast<int>(OperatorState::AFTER_COLON);
+    const int afterLess = static_cast<int>(OperatorState::AFTER_LESS);
+
+    for (int c = 0; c < static_cast<int>(CharClass::COUNT); c++) {
+        dfa.step[start][c] = dfaTake(TokenType::ERROR);      // недопустимый символ
+        dfa.step[afterColon][c] = dfaStop(TokenType::COLON); // одиночное ':'
+        dfa.step[afterLess][c] = dfaStop(TokenType::LESS);   // одиночное '<'
+    }
+    dfa.step[start][static_cast<int>(CharClass::COLON)] = dfaGoTo(OperatorState::AFTER_COLON);
+    dfa.step[start][static_cast<int>(CharClass::LESS)] = dfaGoTo(OperatorState::AFTER_LESS);
+    dfa.step[start][static_cast<int>(CharClass::SEMICOLON)] = dfaTake(TokenType::SEMICOLON);
+    dfa.step[start][static_cast<int>(CharClass::COMMA)] = dfaTake(TokenType::COMMA);
+    dfa.step[start][static_cast<int>(CharClass::LPAREN)] = dfaTake(TokenType::LPAREN);
+    dfa.step[start][static_cast<int>(CharClass::RPAREN)] = dfaTake(TokenType::RPAREN);
+    dfa.step[start][static_cast<int>(CharClass::PLUS)] = dfaTake(TokenType::PLUS);
+    dfa.step[start][static_cast<int>(CharClass::MINUS)] = dfaTake(TokenType::MINUS);
+    dfa.step[start][static_cast<int>(CharClass::EQUAL)] = dfaTake(TokenType::EQUAL);
+    dfa.step[start][static_cast<int>(CharClass::GREATER)] = dfaTake(TokenType::GREATER);
+    dfa.step[afterColon][static_cast<int>(CharClass::EQUAL)] = dfaTake(TokenType::ASSIGN);
+    dfa.step[afterLess][static_cast<int>(CharClass::GREATER)] = dfaTake(TokenType::NOT_EQUAL);
+    return dfa;
+}
+
+constexpr OperatorDfa OPERATOR_DFA = buildOperatorDfa();
+
+// Разбор оператора в тексте в памяти, начиная с p (за текстом - '\0'):
+// тип токена - в type, результат - указатель сразу за лексемой
+inline const char* scanOperator(const char* p, TokenType& type) {
+    OperatorState state = OperatorState::START;
+    for (;;) {
+        const OperatorTransition& step =
+            OPERATOR_DFA.step[static_cast<int>(state)][static_cast<int>(charClass(*p))];
+        if (step.consume) {
+            p++;
+        }
+        if (step.emit) {
+            type = step.type;
+            return p;
+        }
+        state = step.next;
+    }
+}
+
+#endif
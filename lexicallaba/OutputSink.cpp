@@ -0,0 +1,184 @@
+#include "OutputSink.h"
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <fcntl.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Не больше стольких кусков за один writev
+#if defined(IOV_MAX)
+const std::size_t MAX_BLOCKS_PER_CALL = IOV_MAX;
+#else
+const std::size_t MAX_BLOCKS_PER_CALL = 1024;
+#endif
+
+}
+
+OutputSink::OutputSink() : fd(-1), toMemory(true), failed(false), buffer(BUFFER_SIZE) {
+    resetBuffer();
+}
+
+OutputSink::OutputSink(const std::string& filename) : fd(-1), toMemory(false), failed(false), buffer(BUFFER_SIZE) {
+#ifdef _WIN32
+    // Текстовый режим - переводы строк те же, что у std::ofstream
+    fd = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_TEXT, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    resetBuffer();
+}
+
+OutputSink::~OutputSink() {
+    flush();
+    if (fd >= 0) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+}
+
+void OutputSink::writeOut(const char* data, std::size_t size) {
+    if (toMemory) {
+        text.append(data, size);
+        return;
+    }
+    if (fd < 0 || failed) return;
+
+    while (size > 0) {
+#ifdef _WIN32
+        int written = _write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, INT_MAX)));
+#else
+        ssize_t written = ::write(fd, data, size);
+#endif
+        if (written <= 0) {
+            failed = true;
+            return;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+void OutputSink::flush() {
+    std::size_t size = static_cast<std::size_t>(pptr() - pbase());
+    if (size > 0) {
+        writeOut(pbase(), size);
+    }
+    resetBuffer();
+}
+
+void OutputSink::put(const char* data, std::size_t size) {
+    if (size > static_cast<std::size_t>(epptr() - pptr())) {
+        flush();
+        if (size > buffer.size()) {
+            writeOut(data, size);  // больше буфера - сразу в файл
+            return;
+        }
+    }
+    std::memcpy(pptr(), data, size);
+    pbump(static_cast<int>(size));
+}
+
+void OutputSink::writeBlocks(const std::vector<std::string>& blocks) {
+    flush();
+    if (toMemory || fd < 0) {
+        for (const std::string& block : blocks) writeOut(block.data(), block.size());
+        return;
+    }
+#ifdef _WIN32
+    for (const std::string& block : blocks) writeOut(block.data(), block.size());
+#else
+    // Куски уходят одним вызовом (по MAX_BLOCKS_PER_CALL); недописанный хвост дописывается по одному
+    std::size_t first = 0;
+    while (first < blocks.size() && !failed) {
+        std::vector<iovec> parts;
+        std::size_t total = 0;
+        std::size_t last = first;  // куски [first, last) идут в этот вызов
+        for (; last < blocks.size() && parts.size() < MAX_BLOCKS_PER_CALL; last++) {
+            if (blocks[last].empty()) continue;
+            iovec part;
+            part.iov_base = const_cast<char*>(blocks[last].data());
+            part.iov_len = blocks[last].size();
+            parts.push_back(part);
+            total += blocks[last].size();
+        }
+        if (parts.empty()) break;
+
+        ssize_t written = ::writev(fd, parts.data(), static_cast<int>(parts.size()));
+        if (written < 0) {
+            failed = true;
+            return;
+        }
+        if (static_cast<std::size_t>(written) < total) {
+            // Частичная запись: пропускаем записанное и дописываем остаток кусков
+            std::size_t done = static_cast<std::size_t>(written);
+            for (std::size_t i = first; i < last; i++) {
+                std::size_t size = blocks[i].size();
+                if (done >= size) {
+                    done -= size;
+                    continue;
+                }
+                writeOut(blocks[i].data() + done, size - done);
+                done = 0;
+            }
+        }
+        first = last;
+    }
+#endif
+}
+
+std::string OutputSink::takeText() {
+    flush();
+    std::string result;
+    result.swap(text);
+    return result;
+}
+
+OutputSink::int_type OutputSink::overflow(int_type ch) {
+    flush();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize OutputSink::xsputn(const char* data, std::streamsize size) {
+    put(data, static_cast<std::size_t>(size));
+    return size;
+}
+
+int OutputSink::sync() {
+    return 0;
+}
+
+OutputSink& OutputSink::operator<<(const char* s) {
+    put(s, std::strlen(s));
+    return *this;
+}
+
+OutputSink& OutputSink::operator<<(std::int64_t value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    put(digits, static_cast<std::size_t>(result.ptr - digits));
+    return *this;
+}
+
+OutputSink& OutputSink::operator<<(std::uint64_t value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    put(digits, static_cast<std::size_t>(result.ptr - digits));
+    return *this;
+}
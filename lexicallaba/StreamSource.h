@@ -0,0 +1,47 @@
+#pragma once
+#ifndef STREAMSOURCE_H
+#define STREAMSOURCE_H
+
+#include <cstddef>
+#include <vector>
+
+// Потоковый вход (stdin, канал, файл любого размера): байты читаются из
+// дескриптора в буфер фиксированного размера, который перезаполняется.
+// Лексеру отдаётся окно, которое кончается на границе лексем - после последнего
+// пробельного символа или односимвольного разделителя в буфере (или в конце потока),
+// поэтому лексемы никогда не разрываются границей блока, а в следующее окно
+// переносится только начало незаконченной лексемы. Память постоянна и для входа
+// без переводов строк: буфер растёт только под одну лексему длиннее блока.
+class StreamSource {
+private:
+    int fd;                     // дескриптор входного потока (-1 - не открыт)
+    std::vector<char> block;    // буфер: начало незаконченной лексемы + новые байты
+    std::size_t filled;         // сколько байтов буфера заполнено
+    std::size_t windowSize;     // размер окна для лексера (до границы лексем)
+    std::size_t blockOffset;    // смещение block[0] от начала потока
+    bool finished;              // поток прочитан до конца
+
+    void readMore();            // дочитывание до заполнения буфера или конца потока
+
+public:
+    static const std::size_t BLOCK_SIZE = 1 << 16;  // размер блока чтения (байт)
+
+    StreamSource();                          // не связан с потоком
+    explicit StreamSource(int inputFd);      // чтение из дескриптора (0 - stdin)
+
+    StreamSource(const StreamSource&) = delete;
+    StreamSource& operator=(const StreamSource&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Отбрасывает первые consumed байтов окна и готовит следующее окно (false - данных больше нет)
+    bool next(std::size_t consumed);
+
+    const char* begin() const { return block.data(); }               // начало окна
+    const char* end() const { return block.data() + windowSize; }    // конец окна
+    std::size_t offset() const { return blockOffset; }               // смещение начала окна в потоке
+    bool atEnd(std::size_t offset) const { return finished && offset >= blockOffset + filled; } // конец потока
+    std::size_t capacity() const { return block.size(); }            // размер буфера (байт)
+};
+
+#endif
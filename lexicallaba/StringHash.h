@@ -0,0 +1,89 @@
+#pragma once
+#ifndef STRINGHASH_H
+#define STRINGHASH_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// Быстрый хеш строк с зерном для хеш-таблиц: 8 байт за шаг, каждый шаг -
+// 128-битное произведение со сложением его половин. Зерно выбирается случайно
+// один раз за запуск, поэтому набор строк с одинаковым хешем нельзя подобрать
+// заранее (в отличие от многочлена по основанию 31, где "Aa" и "BB" совпадают).
+// Хеш не для хранения: он зависит от зерна и порядка байтов платформы.
+
+// Старшие и младшие 64 бита произведения a * b, сложенные по XOR
+inline std::uint64_t foldedMultiply(std::uint64_t a, std::uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t high;
+    std::uint64_t low = _umul128(a, b, &high);
+    return low ^ high;
+#else
+    // Произведение по 32-битным половинам
+    std::uint64_t aLow = a & 0xFFFFFFFFu, aHigh = a >> 32;
+    std::uint64_t bLow = b & 0xFFFFFFFFu, bHigh = b >> 32;
+    std::uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh;
+    std::uint64_t highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+    std::uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFu) + (highLow & 0xFFFFFFFFu);
+    std::uint64_t low = (middle << 32) | (lowLow & 0xFFFFFFFFu);
+    std::uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+    return low ^ high;
+#endif
+}
+
+// Хеш length байтов с зерном seed
+inline std::uint64_t hashString(const char* data, std::size_t length, std::uint64_t seed) {
+    const std::uint64_t K0 = 0xA0761D6478BD642Full;
+    const std::uint64_t K1 = 0xE7037ED1A0B428DBull;
+    const std::uint64_t K2 = 0x8EBC6AF09C88C6E3ull;
+
+    // Все чтения - фиксированной длины: memcpy переменной длины для хвоста становится
+    // вызовом функции с ветвлениями и на коротких ключах стоит дороже самого хеша
+    std::uint64_t hash = seed ^ (length * K0);
+    std::uint64_t word;
+    if (length >= 8) {
+        const char* last = data + length - 8;
+        for (; data < last; data += 8) {
+            std::memcpy(&word, data, 8);
+            hash = foldedMultiply(word ^ seed ^ K1, hash ^ K2);
+        }
+        std::memcpy(&word, last, 8);  // последние 8 байт (могут перекрываться с предыдущим словом)
+    }
+    else if (length >= 4) {
+        std::uint32_t low, high;      // первые и последние 4 байта (могут перекрываться)
+        std::memcpy(&low, data, 4);
+        std::memcpy(&high, data + length - 4, 4);
+        word = low | static_cast<std::uint64_t>(high) << 32;
+    }
+    else if (length > 0) {
+        word = static_cast<unsigned char>(data[0]) | static_cast<std::uint64_t>(static_cast<unsigned char>(data[length / 2])) << 8
+            | static_cast<std::uint64_t>(static_cast<unsigned char>(data[length - 1])) << 16;
+    }
+    else {
+        word = 0;
+    }
+    hash = foldedMultiply(word ^ seed ^ K1, hash ^ K2);
+    return foldedMultiply(hash ^ K0, seed ^ K2);
+}
+
+// Зерно хеша на этот запуск программы (одно для всех таблиц)
+inline std::uint64_t runHashSeed() {
+    static const std::uint64_t seed = [] {
+        std::random_device device;
+        std::uint64_t value = (static_cast<std::uint64_t>(device()) << 32) ^ device();
+        // random_device бывает детерминированным - добавляем время запуска
+        value ^= static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        return foldedMultiply(value, 0x9E3779B97F4A7C15ull) | 1;
+    }();
+    return seed;
+}
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+#ifndef TOKENBUFFER_H
+#define TOKENBUFFER_H
+
+#include "Token.h"
+#include "LineIndex.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Буфер токенов в виде структуры массивов: поля токена (Token.h) хранятся
+// в трёх плотных массивах - слово со смещением и типом, длина, номер;
+// 16 байт на токен. Текст лексемы не копируется - он берётся из исходных
+// байтов по смещению и длине, а строка и позиция вычисляются по смещению
+// через индекс строк. Поэтому буфер действителен, пока живут исходные байты
+// и индекс строк (входной файл лексера).
+// Для потокового входа исходные байты не хранятся: такой буфер (без source)
+// заполняется push с текстом лексемы и держит копии лексем и их места сам.
+class TokenBuffer {
+private:
+    const char* source;                     // исходные байты, на которые указывают смещения
+    const LineIndex* lineIndex;             // индекс строк исходных байтов
+    std::vector<std::uint64_t> words;       // смещения лексем и типы (Token::word)
+    std::vector<std::uint32_t> lengths;     // длины лексем
+    std::vector<std::uint32_t> ids;         // номера имён, индексы констант, виды ошибок (Token::id)
+
+    // Только для буфера без исходных байтов
+    std::string ownText;                    // копии лексем подряд
+    std::vector<std::size_t> textStarts;    // начала лексем в ownText
+    std::vector<SourceLocation> locations;  // строки и позиции токенов
+
+    friend class TokenCache;                // читает и заполняет массивы целиком
+
+public:
+    explicit TokenBuffer(const char* sourceBytes = nullptr, const LineIndex* lines = nullptr)
+        : source(sourceBytes), lineIndex(lines) {}
+
+    // Добавление токена (текст задаётся смещением и длиной)
+    void push(const Token& token) {
+        words.push_back(token.word);
+        lengths.push_back(token.length);
+        ids.push_back(token.id);
+    }
+    // Добавление токена с копией текста и места (буфер без исходных байтов)
+    void push(const Token& token, std::string_view text, SourceLocation where);
+    // Дописывание другого буфера (с теми же исходными байтами) в конец; constRemap и symbolRemap
+    // переводят индексы констант и номера имён другого буфера в общие (пустые - не меняются)
+    void append(const TokenBuffer& other, const std::vector<std::uint32_t>& constRemap = std::vector<std::uint32_t>(),
+        const std::vector<std::uint32_t>& symbolRemap = std::vector<std::uint32_t>());
+    void reserve(std::size_t count);
+    void clear();                           // удаление всех токенов (память остаётся для следующих)
+    // Замена токенов [first, first + count) токенами replacement; смещения следующих
+    // за ними токенов сдвигаются на offsetShift (только для буфера с исходными байтами)
+    void splice(std::size_t first, std::size_t count, const TokenBuffer& replacement, std::ptrdiff_t offsetShift);
+    // Новые адреса исходных байтов и индекса строк (после правки текста)
+    void rebind(const char* sourceBytes, const LineIndex* lines) { source = sourceBytes; lineIndex = lines; }
+
+    std::size_t size() const { return words.size(); }
+    bool empty() const { return words.empty(); }
+
+    // Доступ к полям по индексу
+    Token at(std::size_t i) const {
+        Token token;
+        token.word = words[i];
+        token.length = lengths[i];
+        token.id = ids[i];
+        return token;
+    }
+    TokenType type(std::size_t i) const { return static_cast<TokenType>(words[i] >> Token::TYPE_SHIFT); }
+    std::size_t offset(std::size_t i) const { return static_cast<std::size_t>(words[i] & Token::OFFSET_MASK); }
+    std::size_t length(std::size_t i) const { return lengths[i]; }
+    SourceLocation location(std::size_t i) const {
+        return lineIndex ? lineIndex->locate(offset(i)) : locations[i];
+    }
+    std::int64_t line(std::size_t i) const { return location(i).line; }
+    std::int64_t position(std::size_t i) const { return location(i).position; }
+    LexError error(std::size_t i) const { return at(i).error(); }
+    std::uint32_t id(std::size_t i) const { return ids[i]; }
+    std::int64_t constIndex(std::size_t i) const { return at(i).constIndex(); }
+    std::int64_t symbol(std::size_t i) const { return at(i).symbol(); }
+    std::string_view lexeme(std::size_t i) const {  // текст без копии (действителен, пока жив буфер и вход)
+        std::size_t size = lengths[i];
+        if (size == 0) return std::string_view();
+        return source ? std::string_view(source + offset(i), size) : std::string_view(ownText.data() + textStarts[i], size);
+    }
+    std::string text(std::size_t i) const { return std::string(lexeme(i)); }
+};
+
+#endif
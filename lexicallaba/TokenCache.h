@@ -0,0 +1,40 @@
+#pragma once
+#ifndef TOKENCACHE_H
+#define TOKENCACHE_H
+
+#include "TokenBuffer.h"
+#include "ConstantPool.h"
+#include "OpenHashMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Кэш токенов на диске (.tok): типы токенов по байту, номера только у ID, CONST и ERROR,
+// места лексем varint-разностями, пул констант и таблица имён (место первого вхождения
+// каждого имени во входе). Файл привязан к входу хешем и размером исходных байтов.
+// При чтении файл отображается в память и раскладывается в столбцы буфера за один проход
+// с проверкой границ каждого поля - устаревший кэш и кэш с полем за пределами входа,
+// пула или таблицы имён не загружаются. Контрольной суммы нет: файл пишет сам лексер.
+// Имена вставляются в таблицу по одному разу, лексемы ID заново не хешируются.
+// Таблица идентификаторов (HashTable) заполняется при выводе токенов и в кэше не нужна.
+class TokenCache {
+public:
+    static const std::uint32_t VERSION = 6;  // менять при любом изменении формата или токенов
+    static const std::size_t MIN_SOURCE_SIZE = 1 << 20;  // меньший вход быстрее разобрать, чем читать кэш (байт)
+
+    // Ключ входа: hashString из StringHash.h с постоянным зерном (каждое 8-байтовое слово
+    // перемешивается умножением, поэтому согласованные правки двух слов не сокращаются)
+    static std::uint64_t hashBytes(const char* begin, const char* end);
+
+    // Загрузка токенов входа [sourceBegin, sourceEnd) в пустые tokens, constants и names.
+    // false - файла нет, он от другого входа или поля вне границ (tokens, constants и names не меняются)
+    static bool load(const std::string& cachePath, const char* sourceBegin, const char* sourceEnd,
+        TokenBuffer& tokens, ConstantPool& constants, OpenHashSet& names);
+
+    // Запись кэша (через временный файл, чтобы не оставить недописанный кэш).
+    // false - ещё и для буфера, чьи имена пронумерованы не в порядке появления
+    static bool save(const std::string& cachePath, const char* sourceBegin, const char* sourceEnd,
+        const TokenBuffer& tokens, const ConstantPool& constants);
+};
+
+#endif
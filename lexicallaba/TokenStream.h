@@ -0,0 +1,75 @@
+#pragma once
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include "Token.h"
+#include "TokenBuffer.h"
+#include "OpenHashMap.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+class Lexer;
+
+// Источник токенов, из которого потребитель (парсер) вытягивает токены по одному.
+// Лексер за таким источником работает ровно тогда, когда нужен следующий токен,
+// поэтому разбор входа чередуется с разбором грамматики без буфера на весь вход.
+// Токен - 16 байт (Token.h); текст и место последнего выданного токена - у источника.
+class TokenStream {
+public:
+    virtual ~TokenStream() {}
+    virtual Token next() = 0;  // следующий токен (после END_OF_FILE - снова END_OF_FILE)
+    virtual SourceLocation location() const = 0;  // строка и позиция последнего токена
+    // Текст последнего токена. Вид действителен, пока живут источник и его входные байты
+    // (не только до следующего next()): узлы дерева разбора хранят его без копии
+    virtual std::string_view text() = 0;
+};
+
+// Токены из готового буфера. Класс final, а методы встроены: парсер, знающий,
+// что разбирает буфер, вызывает их без виртуального вызова на каждый токен.
+class BufferTokenStream final : public TokenStream {
+private:
+    const TokenBuffer& tokens;  // буфер (последний токен - END_OF_FILE)
+    std::size_t index;          // индекс следующего токена
+    std::size_t current;        // индекс последнего выданного токена
+
+    std::size_t clamp(std::size_t i) const { return i < tokens.size() ? i : tokens.size() - 1; }
+
+public:
+    explicit BufferTokenStream(const TokenBuffer& buffer) : tokens(buffer), index(0), current(0) {}
+
+    Token next() override {
+        current = index;
+        if (index + 1 < tokens.size()) {
+            index++;  // на последнем токене (END_OF_FILE) остаёмся
+        }
+        return tokens.at(current);
+    }
+    SourceLocation location() const override { return tokens.location(current); }
+    std::string_view text() override { return tokens.lexeme(current); }
+
+    // Заглядывание вперёд на любую глубину - просто индекс в буфере:
+    // peek(0) - тип токена, который вернёт следующий next() (за концом - END_OF_FILE)
+    TokenType peek(std::size_t k) const { return tokens.type(clamp(index + k)); }
+    // Пропуск count токенов без их выдачи: следующий next() вернёт токен через count
+    void skip(std::size_t count) { index = clamp(index + count); }
+};
+
+// Токены прямо из лексера: каждый разбирается по запросу
+class LexerTokenStream : public TokenStream {
+private:
+    Lexer& lexer;
+    Token current;             // последний выданный токен
+    SourceLocation where;      // его место (у потокового входа известно только сразу после разбора)
+    // Тексты лексем потокового входа: окно потока перезаписывается, поэтому текст
+    // копируется сюда - каждая разная лексема один раз (память не растёт с длиной входа)
+    OpenHashSet texts;
+
+public:
+    explicit LexerTokenStream(Lexer& source);
+    Token next() override;
+    SourceLocation location() const override { return where; }
+    std::string_view text() override;
+};
+
+#endif
@@ -1,24 +1,36 @@
-#include "Lexer.h"
-#include <iostream>
-#include <windows.h>
-
-int main() {
-    SetConsoleOutputCP(1251);
-    std::string inputFile = "input.txt";
-    std::string outputFile = "output.txt";
-
-    //   
-    Lexer lexer(inputFile, outputFile);
-
-    //  
-    lexer.analyze();
-
-    if (lexer.hasErrors()) {
-        std::cout << "    .   ." << std::endl;
-    }
-    else {
-        std::cout << "   ." << std::endl;
-    }
-
-    return 0;
+#include "Lexer.h"
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <windows.h>
+
+int main(int argc, char* argv[]) {
+    SetConsoleOutputCP(1251);
+    // Входной файл можно передать аргументом; "-" - читать программу из stdin (канал, генератор)
+    std::string inputFile = argc > 1 ? argv[1] : "input.txt";
+    std::string outputFile = "output.txt";
+
+    // Создаем лексический анализатор
+    std::unique_ptr<Lexer> lexer(inputFile == "-"
+        ? new Lexer(0, outputFile)
+        : new Lexer(inputFile, outputFile));
+
+    // Запускаем анализ: большие файлы разбираются параллельно, токены неизменного
+    // входа от 1 МБ - из кэша рядом с ним (<вход>.tok); поток из stdin не кэшируется
+    if (inputFile == "-") {
+        lexer->analyze(std::thread::hardware_concurrency());
+    }
+    else {
+        unsigned threads = std::thread::hardware_concurrency();
+        lexer->report(lexer->tokenizeCached(inputFile + ".tok", threads), threads);
+    }
+
+    if (lexer->hasErrors()) {
+        std::cout << "Лексический анализ завершен с ошибками. Проверьте выходной файл." << std::endl;
+    }
+    else {
+        std::cout << "Лексический анализ успешно завершен." << std::endl;
+    }
+
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "IncrementalLexer.h"
+#include "Lexer.h"
+#include <utility>
+
+IncrementalLexer::IncrementalLexer(std::string source)
+    : text(std::move(source)), lineIndex(text.data(), text.data() + text.size()) {
+    tokens.rebind(text.data(), &lineIndex);
+
+    Lexer lexer(text.data(), text.data(), text.data() + text.size());
+    while (lexer.scanInto(tokens)) {
+    }
+    constantPool = std::move(lexer.constantPool);
+    names = std::move(lexer.names);
+}
+
+TokenRange IncrementalLexer::applyEdit(std::size_t offset, std::size_t removed, const std::string& inserted) {
+    if (offset > text.size()) offset = text.size();
+    if (removed > text.size() - offset) removed = text.size() - offset;
+    const std::size_t editEnd = offset + removed;  // конец удалённого участка в старом тексте
+    const std::ptrdiff_t shift = static_cast<std::ptrdiff_t>(inserted.size()) - static_cast<std::ptrdiff_t>(removed);
+
+    // Первый повреждённый токен - первый, который кончается не раньше offset
+    // (токен, кончающийся ровно на offset, мог смотреть на следующий символ)
+    std::size_t lo = 0, hi = tokens.size();
+    while (lo < hi) {
+        std::size_t mid = (lo + hi) / 2;
+        if (tokens.offset(mid) + tokens.length(mid) < offset) lo = mid + 1;
+        else hi = mid;
+    }
+    const std::size_t first = lo;
+
+    text.replace(offset, removed, inserted);
+    lineIndex.update(offset, removed, inserted.data(), inserted.size());
+    tokens.rebind(text.data(), &lineIndex);
+
+    if (first == tokens.size()) {
+        return { first, 0, 0 };  // правка после конца разбора (после символа '\0')
+    }
+
+    // Разбор начинается сразу после последнего неповреждённого токена
+    std::size_t restart = first > 0 ? tokens.offset(first - 1) + tokens.length(first - 1) : 0;
+    Lexer lexer(text.data(), text.data() + restart, text.data() + text.size());
+
+    TokenBuffer fresh(text.data(), &lineIndex);
+    std::size_t old = first;  // старый токен-кандидат для синхронизации
+    for (;;) {
+        Token token = lexer.scanToken();
+
+        // Синхронизация: старый токен целиком после правки и начинается там же
+        while (old < tokens.size() &&
+            (tokens.offset(old) < editEnd ||
+                static_cast<std::ptrdiff_t>(tokens.offset(old)) + shift < static_cast<std::ptrdiff_t>(token.offset()))) {
+            old++;
+        }
+        if (old < tokens.size() && static_cast<std::ptrdiff_t>(tokens.offset(old)) + shift ==
+            static_cast<std::ptrdiff_t>(token.offset())) {
+            break;  // дальше разбор совпадёт со старым - остальные токены только сдвигаются
+        }
+
+        // Индексы констант и номера имён нового лексера переводятся в общие
+        if (token.type() == TokenType::CONST) {
+            token.id = constantPool.intern(lexer.constantPool.value(token.id));
+        }
+        else if (token.type() == TokenType::ID) {
+            token.id = static_cast<std::uint32_t>(names.insert(lexer.names.key(token.id)).first);
+        }
+        fresh.push(token);
+        if (token.type() == TokenType::END_OF_FILE) {
+            old = tokens.size();  // дошли до конца - заменяются все старые токены
+            break;
+        }
+    }
+
+    tokens.splice(first, old - first, fresh, shift);
+    return { first, old - first, fresh.size() };
+}
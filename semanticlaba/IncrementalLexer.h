@@ -0,0 +1,48 @@
+#pragma once
+#ifndef INCREMENTALLEXER_H
+#define INCREMENTALLEXER_H
+
+#include "TokenBuffer.h"
+#include "LineIndex.h"
+#include "ConstantPool.h"
+#include "OpenHashMap.h"
+#include <cstddef>
+#include <string>
+
+// Диапазон токенов, изменённых правкой: старые токены [first, first + removed)
+// заменены новыми [first, first + inserted), остальные только сдвинуты
+struct TokenRange {
+    std::size_t first;
+    std::size_t removed;
+    std::size_t inserted;
+};
+
+// Лексер для редактируемого текста: после правки перелексируется только
+// повреждённый участок. Лексемы не содержат переводов строк и разбор каждой
+// зависит лишь от её байтов и одного символа после неё, поэтому разбор
+// начинается с последнего неповреждённого токена и заканчивается, как только
+// новый токен начинается там же, где (со сдвигом) начинался старый токен после правки.
+class IncrementalLexer {
+private:
+    std::string text;          // текущий текст программы
+    LineIndex lineIndex;       // начала строк текста
+    ConstantPool constantPool; // значения констант (старые значения не удаляются)
+    OpenHashSet names;         // имена (старые имена не удаляются)
+    TokenBuffer tokens;        // токены текста (последний - END_OF_FILE)
+
+public:
+    explicit IncrementalLexer(std::string source);  // полный разбор исходного текста
+
+    IncrementalLexer(const IncrementalLexer&) = delete;
+    IncrementalLexer& operator=(const IncrementalLexer&) = delete;
+
+    // Правка: байты [offset, offset + removed) заменяются на inserted
+    TokenRange applyEdit(std::size_t offset, std::size_t removed, const std::string& inserted);
+
+    const std::string& getText() const { return text; }
+    const TokenBuffer& getTokens() const { return tokens; }
+    const ConstantPool& constants() const { return constantPool; }
+    const OpenHashSet& symbols() const { return names; }
+};
+
+#endif
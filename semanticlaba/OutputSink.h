@@ -0,0 +1,67 @@
+#pragma once
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Общий выходной файл всех этапов анализа. Вывод копится в большом буфере и уходит
+// в файл редкими системными вызовами: при заполнении буфера, по flush() и в деструкторе.
+// Числа форматируются std::to_chars (без локали и состояния потока).
+// Это и std::streambuf: парсер и семантический анализатор пишут в std::ostream поверх
+// того же буфера, порядок вывода сохраняется, а std::endl не вызывает записи в файл.
+// Без имени файла вывод копится в памяти (takeText) - так куски таблицы лексем
+// форматируются параллельно, а в файл попадают по порядку одним writev.
+class OutputSink : public std::streambuf {
+private:
+    int fd;                     // дескриптор выходного файла (-1 - вывод в память или файл не открыт)
+    bool toMemory;              // вывод копится в text
+    bool failed;                // запись в файл не удалась
+    std::vector<char> buffer;   // буфер форматирования (область записи streambuf)
+    std::string text;           // вывод в память
+
+    void resetBuffer() { setp(buffer.data(), buffer.data() + buffer.size()); }
+    void writeOut(const char* data, std::size_t size);  // запись мимо буфера
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* data, std::streamsize size) override;
+    int sync() override;  // ничего не пишет: сброс буфера только по flush()
+
+public:
+    static const std::size_t BUFFER_SIZE = 1 << 20;  // размер буфера (байт)
+
+    OutputSink();                                    // вывод в память
+    explicit OutputSink(const std::string& filename);  // файл создаётся заново
+    ~OutputSink();
+
+    OutputSink(const OutputSink&) = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    bool isOpen() const { return toMemory || fd >= 0; }
+    bool good() const { return !failed; }
+
+    void put(const char* data, std::size_t size);
+    void flush();                                    // запись буфера в файл (в память)
+    void writeBlocks(const std::vector<std::string>& blocks);  // готовые куски по порядку, одним writev
+    std::string takeText();                          // накопленный вывод в память (буфер очищается)
+
+    OutputSink& operator<<(char c) {
+        if (pptr() == epptr()) flush();
+        *pptr() = c;
+        pbump(1);
+        return *this;
+    }
+    OutputSink& operator<<(const char* s);
+    OutputSink& operator<<(const std::string& s) { put(s.data(), s.size()); return *this; }
+    OutputSink& operator<<(std::string_view s) { put(s.data(), s.size()); return *this; }
+    OutputSink& operator<<(int value) { return *this << static_cast<std::int64_t>(value); }
+    OutputSink& operator<<(std::int64_t value);
+    OutputSink& operator<<(std::uint64_t value);
+};
+
+#endif
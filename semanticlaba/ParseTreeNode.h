@@ -1,28 +1,32 @@
-#ifndef PARSETREENODE_H
-#define PARSETREENODE_H
-
-#include <string>
-#include <vector>
-
-//        
-struct ParseTreeNode {
-    std::string name;                       //   ( )
-    std::string value;                      //  ( )
-    std::vector<ParseTreeNode*> children;   //  
-    int line;                               //     
-    int position;                           //   
-
-    // 
-    ParseTreeNode(const std::string& n, const std::string& v = "", int l = 0, int p = 0)
-        : name(n), value(v), line(l), position(p) {
-    }
-
-    // 
-    ~ParseTreeNode() {
-        for (auto child : children) {
-            delete child;
-        }
-    }
-};
-
+#ifndef PARSETREENODE_H
+#define PARSETREENODE_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Узел дерева разбора для хранения синтаксической структуры программы.
+// Имя - строковый литерал, значение - вид на текст лексемы у источника токенов
+// (входные байты лексера): строки в узлах не копируются.
+struct ParseTreeNode {
+    std::string_view name;                  // Имя узла (тип конструкции)
+    std::string_view value;                 // Значение (для терминалов)
+    std::vector<ParseTreeNode*> children;   // Дочерние узлы
+    std::int64_t line;                      // Номер строки в исходном коде
+    std::int64_t position;                  // Позиция в строке
+    std::int64_t constIndex;                // Индекс значения в пуле констант (для "const", иначе -1)
+
+    // Конструктор
+    ParseTreeNode(std::string_view n, std::string_view v = std::string_view(), std::int64_t l = 0, std::int64_t p = 0, std::int64_t c = -1)
+        : name(n), value(v), line(l), position(p), constIndex(c) {
+    }
+
+    // Деструктор
+    ~ParseTreeNode() {
+        for (auto child : children) {
+            delete child;
+        }
+    }
+};
+
 #endif
\ No newline at end of file
@@ -1,50 +1,73 @@
-#ifndef PARSER_H
-#define PARSER_H
-
-#include "Lexer.h"
-#include "ParseTreeNode.h"
-#include <fstream>
-#include <string>
-#include <vector>
-
-class Parser {
-private:
-    Lexer& lexer;
-    std::ofstream& outputFile;
-    Token currentToken;
-    bool hasError;
-    std::vector<std::string> errorMessages;
-    ParseTreeNode* parseTreeRoot;  //  :   
-
-    void checkSemicolon();
-    void advanceToken();
-    bool match(TokenType expectedType);
-    void error(const std::string& message);
-    void syncTo(const std::vector<TokenType>& syncTokens);
-    void printTree(ParseTreeNode* node, int depth = 0);
-    void printErrors();
-
-    //  
-    ParseTreeNode* parseProcedure();
-    ParseTreeNode* parseBegin();
-    ParseTreeNode* parseDescriptions();
-    ParseTreeNode* parseDescrList();
-    ParseTreeNode* parseDescr();
-    ParseTreeNode* parseVarList();
-    ParseTreeNode* parseOperators();
-    ParseTreeNode* parseOp();
-    ParseTreeNode* parseAssignment();
-    ParseTreeNode* parseIfStatement();
-    ParseTreeNode* parseExpr();
-    ParseTreeNode* parseSimpleExpr();
-    ParseTreeNode* parseCondition();
-
-public:
-    Parser(Lexer& lex, std::ofstream& out);
-    bool parse();                         //   ( )
-    bool parseForSemantic();              //   ( )
-    ParseTreeNode* getParseTree() const { return parseTreeRoot; }  //  
-    bool hasErrors() const { return hasError; }
-};
-
+#ifndef PARSER_H
+#define PARSER_H
+
+#include "Lexer.h"
+#include "TokenBuffer.h"
+#include "TokenStream.h"
+#include "ParseTreeNode.h"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Parser {
+private:
+    std::unique_ptr<TokenStream> ownStream;  // источник, созданный самим парсером
+    TokenStream& tokens;           // источник токенов, из которого идёт разбор
+    BufferTokenStream* bufferTokens;  // тот же источник, если это буфер (иначе nullptr)
+    std::ostream& outputFile;      // куда выводится отчёт (файл, строка или пустой поток)
+    Token currentToken;            // текущий токен (16 байт; текст и место - у источника)
+    SourceLocation currentLocation;  // строка и позиция текущего токена
+    bool hasError;
+    std::vector<std::string> errorMessages;
+    ParseTreeNode* parseTreeRoot;  // НОВОЕ ПОЛЕ: корень дерева разбора
+    std::function<void(ParseTreeNode*)> statementSink;  // получатель готовых частей дерева (может быть пустым)
+    bool keepOperators;            // сохранять ли разобранные операторы в дереве
+
+    void checkSemicolon();
+    void advanceToken();
+    std::string_view currentText();  // текст текущего токена
+    bool match(TokenType expectedType);
+    bool isIdentifierError();
+    void error(const std::string& message);
+    void syncTo(const std::vector<TokenType>& syncTokens);
+    void printTree(ParseTreeNode* node, int depth = 0);
+    void printErrors();
+    void emitStatement(ParseTreeNode* node);  // передача готового узла получателю
+
+    // Правила грамматики
+    ParseTreeNode* parseProcedure();
+    ParseTreeNode* parseBegin();
+    ParseTreeNode* parseDescriptions();
+    ParseTreeNode* parseDescrList();
+    ParseTreeNode* parseDescr();
+    ParseTreeNode* parseVarList();
+    ParseTreeNode* parseOperators();
+    ParseTreeNode* parseOp();
+    ParseTreeNode* parseAssignment();
+    ParseTreeNode* parseIfStatement();
+    ParseTreeNode* parseExpr();
+    ParseTreeNode* parseSimpleExpr();
+    ParseTreeNode* parseCondition();
+
+public:
+    Parser(Lexer& lex, std::ostream& out);
+    Parser(const TokenBuffer& tokenBuffer, std::ostream& out);  // разбор готового буфера токенов
+    Parser(TokenStream& tokenStream, std::ostream& out);        // разбор токенов из источника
+    bool parse();                         // Разбор с выводом дерева (дерево сохраняется)
+    bool parseForSemantic();              // Новый метод (сохраняет дерево)
+    // Получатель узла Descriptions и каждого оператора верхнего уровня сразу после их разбора
+    // (пока в программе нет синтаксических ошибок). Узлы остаются в дереве и больше не меняются.
+    void setStatementSink(std::function<void(ParseTreeNode*)> sink) { statementSink = std::move(sink); }
+    // keep = false: оператор удаляется сразу после передачи получателю, и память разбора
+    // не растёт с длиной программы (потоковый разбор многогигабайтного входа)
+    void setKeepOperators(bool keep) { keepOperators = keep; }
+    ParseTreeNode* getParseTree() const { return parseTreeRoot; }  // Получение дерева
+    bool hasErrors() const { return hasError; }
+    const std::vector<std::string>& getErrors() const { return errorMessages; }  // сообщения об ошибках
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include "Pipeline.h"
+#include "LexErrors.h"
+#include "Parser.h"
+#include "SemanticAnalyzer.h"
+#include "SpscRing.h"
+#include "TokenStream.h"
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace {
+
+const std::size_t TOKEN_BATCH_SIZE = 4096;    // токенов в одной пачке от лексера
+const std::size_t TOKEN_RING_BATCHES = 8;     // пачек в очереди лексер -> парсер
+const std::size_t STATEMENT_RING_SIZE = 256;  // узлов в очереди парсер -> семантический анализ
+
+// Пачка токенов (смещения и длины в исходных байтах, без копий лексем)
+// и константы, попавшие в пул лексера к концу её разбора
+struct TokenBatch {
+    TokenBuffer tokens;
+    std::vector<std::int64_t> constants;
+};
+
+// Готовая часть дерева для семантического анализа (node == nullptr - конец разбора)
+// и новые константы пула, на которые она может ссылаться
+struct StatementItem {
+    ParseTreeNode* node = nullptr;
+    std::vector<std::int64_t> constants;
+};
+
+// Источник токенов для парсера: пачки из очереди от потока лексера.
+// Каждая полученная пачка дописывается в общий буфер токенов (его меняет только этот поток)
+class RingTokenStream : public TokenStream {
+private:
+    SpscRing<TokenBatch>& ring;
+    TokenBuffer& all;                          // все токены программы
+    TokenBatch batch;                          // текущая пачка
+    std::size_t index;                         // следующий токен пачки
+    std::size_t current;                       // последний выданный токен пачки
+    bool finished;                             // END_OF_FILE уже выдан (он остаётся последним в пачке)
+    std::vector<std::int64_t> pendingConstants;  // константы, ещё не переданные дальше
+
+public:
+    RingTokenStream(SpscRing<TokenBatch>& source, TokenBuffer& allTokens)
+        : ring(source), all(allTokens), index(0), current(0), finished(false) {}
+
+    Token next() override {
+        if (finished) return batch.tokens.at(current);
+        while (index == batch.tokens.size()) {
+            batch = ring.pop();
+            index = 0;
+            all.append(batch.tokens);
+            pendingConstants.insert(pendingConstants.end(), batch.constants.begin(), batch.constants.end());
+        }
+        current = index++;
+        Token token = batch.tokens.at(current);
+        finished = token.type() == TokenType::END_OF_FILE;
+        return token;
+    }
+
+    SourceLocation location() const override { return batch.tokens.location(current); }
+    // Пачки указывают на исходные байты конвейера - вид действителен после смены пачки
+    std::string_view text() override { return batch.tokens.lexeme(current); }
+
+    // Вычитывание оставшихся токенов: лексер не должен ждать места в очереди вечно
+    void drain() {
+        while (!finished) next();
+    }
+
+    // То же после ошибки разбора: пачки только выбрасываются, память не выделяется
+    void discardRest() {
+        while (!finished) {
+            batch = ring.pop();
+            finished = !batch.tokens.empty() && batch.tokens.type(batch.tokens.size() - 1) == TokenType::END_OF_FILE;
+        }
+    }
+
+    // Константы, пришедшие с момента прошлого вызова
+    std::vector<std::int64_t> takeConstants() {
+        std::vector<std::int64_t> result;
+        result.swap(pendingConstants);
+        return result;
+    }
+};
+
+// Ожидание потока при выходе из области видимости, в том числе по исключению
+// (деструктор присоединяемого std::thread вызвал бы std::terminate). Перед ожиданием
+// release разблокирует поток: ему может не хватать места или данных в очереди
+class JoinGuard {
+private:
+    std::thread& thread;
+    std::function<void()> release;
+
+public:
+    JoinGuard(std::thread& stage, std::function<void()> unblock) : thread(stage), release(std::move(unblock)) {}
+    ~JoinGuard() {
+        if (thread.joinable()) {
+            release();
+            thread.join();
+        }
+    }
+
+    JoinGuard(const JoinGuard&) = delete;
+    JoinGuard& operator=(const JoinGuard&) = delete;
+};
+
+}
+
+Pipeline::Pipeline(std::string_view source, std::ostream* syntaxSink, std::ostream* semanticSink, PipelineMode mode)
+    : lexer(source.data(), source.size()), parseTree(nullptr), discard(nullptr), semanticDone(false) {
+    std::ostream& syntaxOut = syntaxSink ? *syntaxSink : discard;
+    std::ostream& semanticOut = semanticSink ? *semanticSink : discard;
+
+    if (mode == PipelineMode::PIPELINED) {
+        runPipelined(syntaxOut, semanticOut);
+    }
+    else {
+        runSequential(syntaxOut, semanticOut);
+    }
+}
+
+void Pipeline::collectLexicalErrors() {
+    for (std::size_t i = 0; i < tokens.size(); i++) {
+        if (tokens.type(i) == TokenType::ERROR) {
+            std::ostringstream message;
+            writeLexError(message, tokens.location(i), tokens.lexeme(i), tokens.error(i));
+            lexicalErrors.push_back(message.str());
+        }
+    }
+}
+
+void Pipeline::runSequential(std::ostream& syntaxOut, std::ostream& semanticOut) {
+    // Лексический анализ: токены и сообщения об ошибках
+    tokens = lexer.tokenize();
+    collectLexicalErrors();
+
+    // Синтаксический анализ по готовому буферу токенов, дерево сохраняется
+    Parser parser(tokens, syntaxOut);
+    parser.parseForSemantic();
+    parseTree = parser.getParseTree();
+    syntaxErrors = parser.getErrors();
+
+    // Семантический анализ - только для программы без ошибок
+    if (parseTree && lexicalErrors.empty() && !parser.hasErrors()) {
+        SemanticAnalyzer analyzer(semanticOut, &lexer.constants());
+        analyzer.analyze(parseTree);
+        semanticErrors = analyzer.getErrors();
+        postfixCode = analyzer.getPostfixCode();
+        semanticDone = true;
+    }
+}
+
+// Три потока: лексер -> (пачки токенов) -> парсер -> (операторы) -> семантический анализ.
+// Семантический анализ идёт заранее, пока неизвестно, будут ли ошибки; его результат
+// используется, только если лексических и синтаксических ошибок нет - как в последовательном режиме.
+// Исключение любого этапа доходит до вызывающего: потоки этапов перехватывают его и доводят
+// очереди до конца, а исключение парсера разблокирует и дожидается их через JoinGuard.
+void Pipeline::runPipelined(std::ostream& syntaxOut, std::ostream& semanticOut) {
+    SpscRing<TokenBatch> tokenRing(TOKEN_RING_BATCHES);
+    SpscRing<StatementItem> statementRing(STATEMENT_RING_SIZE);
+
+    // Лексер: токены пачками уходят парсеру, тексты лексем не копируются -
+    // и пачки, и общий буфер указывают на исходные байты
+    tokens = lexer.newBuffer();
+    RingTokenStream stream(tokenRing, tokens);
+    std::exception_ptr lexerError;
+    std::thread lexerThread([this, &tokenRing, &lexerError]() {
+        TokenBatch batch;
+        try {
+            batch.tokens = lexer.newBuffer();
+            batch.tokens.reserve(TOKEN_BATCH_SIZE);
+            std::size_t sentConstants = 0;
+            bool end = false;
+            while (!end) {
+                end = !lexer.readNext(batch.tokens);
+
+                if (end || batch.tokens.size() == TOKEN_BATCH_SIZE) {
+                    // Пул лексера меняется в этом потоке, поэтому дальше идут копии новых значений
+                    const ConstantPool& pool = lexer.constants();
+                    for (; sentConstants < pool.size(); sentConstants++) {
+                        batch.constants.push_back(pool.value(sentConstants));
+                    }
+                    tokenRing.push(std::move(batch));
+                    batch = TokenBatch();
+                    batch.tokens = lexer.newBuffer();
+                    batch.tokens.reserve(TOKEN_BATCH_SIZE);
+                }
+            }
+        }
+        catch (...) {
+            // Парсер получает конец входа и завершается; исключение передаётся после join
+            lexerError = std::current_exception();
+            batch = TokenBatch();
+            batch.tokens = lexer.newBuffer();
+            batch.tokens.push(Token(TokenType::END_OF_FILE, 0));
+            tokenRing.push(std::move(batch));
+        }
+    });
+    JoinGuard lexerGuard(lexerThread, [&stream]() { stream.discardRest(); });
+
+    // Семантический анализ: копия пула (индексы те же) и проверка узлов по мере разбора
+    ConstantPool semanticConstants;
+    SemanticAnalyzer analyzer(semanticOut, &semanticConstants);
+    std::exception_ptr semanticError;
+    std::thread semanticThread([&statementRing, &semanticConstants, &analyzer, &semanticError]() {
+        for (;;) {
+            StatementItem item = statementRing.pop();
+            if (semanticError) {
+                if (!item.node) break;
+                continue;  // после ошибки очередь только вычитывается до конца, чтобы парсер не ждал
+            }
+            try {
+                for (std::int64_t value : item.constants) {
+                    semanticConstants.intern(value);
+                }
+                if (!item.node) break;
+
+                if (item.node->name == "Descriptions") {
+                    analyzer.analyzeDescriptions(item.node);
+                }
+                else {
+                    analyzer.analyzeOperator(item.node);
+                }
+            }
+            catch (...) {
+                semanticError = std::current_exception();
+                if (!item.node) break;
+            }
+        }
+    });
+    JoinGuard semanticGuard(semanticThread, [&statementRing]() { statementRing.push(StatementItem()); });
+
+    // Синтаксический анализ - в вызывающем потоке
+    Parser parser(stream, syntaxOut);
+    parser.setStatementSink([&statementRing, &stream](ParseTreeNode* node) {
+        StatementItem item;
+        item.node = node;
+        item.constants = stream.takeConstants();
+        statementRing.push(std::move(item));
+    });
+    parser.parseForSemantic();  // исключение отсюда: потоки разблокируют и дождутся JoinGuard
+    statementRing.push(StatementItem());
+    stream.drain();
+
+    lexerThread.join();
+    semanticThread.join();
+    if (lexerError) std::rethrow_exception(lexerError);
+    if (semanticError) std::rethrow_exception(semanticError);
+
+    parseTree = parser.getParseTree();
+    syntaxErrors = parser.getErrors();
+    collectLexicalErrors();
+
+    // Отчёт семантического анализа - только для программы без ошибок
+    if (parseTree && lexicalErrors.empty() && !parser.hasErrors()) {
+        analyzer.finish();
+        semanticErrors = analyzer.getErrors();
+        postfixCode = analyzer.getPostfixCode();
+        semanticDone = true;
+    }
+}
+
+Pipeline::~Pipeline() {
+    delete parseTree;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "Lexer.h"
+#include "TokenBuffer.h"
+#include "ConstantPool.h"
+#include "ParseTreeNode.h"
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Как выполняются этапы анализа
+enum class PipelineMode {
+    SEQUENTIAL,  // лексер, парсер и семантический анализ друг за другом в вызывающем потоке
+    PIPELINED    // каждый этап в своём потоке, этапы связаны ограниченными очередями
+};
+
+// Весь анализ программы в памяти: лексический, синтаксический и семантический.
+// Файлы не создаются; отчёты парсера и семантического анализатора пишутся
+// в переданные потоки, а если потоки не заданы - никуда не пишутся.
+// Результаты (токены, дерево, ошибки, постфиксная запись) доступны через методы.
+// Экземпляры независимы и могут работать одновременно в разных потоках.
+// Исходный текст не копируется и должен жить, пока жив Pipeline.
+// В режиме PIPELINED лексер отдаёт токены пачками (смещения и длины без копий лексем)
+// парсеру, а парсер - готовые операторы семантическому анализатору, пока сам разбирает
+// следующие. Результаты и отчёты совпадают с последовательным режимом, отчёт
+// семантического анализа пишется после всех этапов. Исключение любого этапа доходит до
+// вызывающего, потоки этапов к этому времени завершены. Режим по умолчанию - SEQUENTIAL:
+// на одном ядре PIPELINED медленнее из-за передачи между потоками, а выигрыш на нескольких
+// ядрах показывает bench (`speedup` в pipeline_pipelined).
+class Pipeline {
+private:
+    Lexer lexer;                               // лексер по байтам исходного текста
+    TokenBuffer tokens;                        // все токены программы
+    ParseTreeNode* parseTree;                  // дерево разбора (nullptr - не построено)
+    std::ostream discard;                      // пустой поток для отключённых отчётов
+
+    std::vector<std::string> lexicalErrors;    // ошибки лексического анализа
+    std::vector<std::string> syntaxErrors;     // ошибки синтаксического анализа
+    std::vector<std::string> semanticErrors;   // ошибки семантического анализа
+    std::string postfixCode;                   // постфиксная запись программы
+    bool semanticDone;                         // выполнялся ли семантический анализ
+
+    void runSequential(std::ostream& syntaxOut, std::ostream& semanticOut);
+    void runPipelined(std::ostream& syntaxOut, std::ostream& semanticOut);
+    void collectLexicalErrors();               // сообщения об ошибочных токенах буфера
+
+public:
+    // Анализ выполняется сразу в конструкторе
+    explicit Pipeline(std::string_view source, std::ostream* syntaxSink = nullptr,
+        std::ostream* semanticSink = nullptr, PipelineMode mode = PipelineMode::SEQUENTIAL);
+    ~Pipeline();
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    const TokenBuffer& getTokens() const { return tokens; }
+    const ConstantPool& getConstants() const { return lexer.constants(); }
+    ParseTreeNode* getParseTree() const { return parseTree; }  // владеет Pipeline
+    const std::vector<std::string>& getLexicalErrors() const { return lexicalErrors; }
+    const std::vector<std::string>& getSyntaxErrors() const { return syntaxErrors; }
+    const std::vector<std::string>& getSemanticErrors() const { return semanticErrors; }
+    const std::string& getPostfixCode() const { return postfixCode; }
+
+    // Семантический анализ выполняется, только если предыдущие этапы прошли без ошибок
+    bool semanticAnalyzed() const { return semanticDone; }
+    bool hasErrors() const {
+        return !lexicalErrors.empty() || !syntaxErrors.empty() || !semanticErrors.empty() || !semanticDone;
+    }
+};
+
+#endif
@@ -1,104 +1,114 @@
-#ifndef SEMANTICANALYZER_H
-#define SEMANTICANALYZER_H
-
-#include "ParseTreeNode.h"
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
-#include <stack>
-#include <string>
-#include <fstream>
-
-//      
-struct VariableInfo {
-    std::string name;
-    std::string type;
-    int line;          //  
-    int position;      //   
-
-    //   
-    VariableInfo() : name(""), type(""), line(0), position(0) {}
-
-    //   
-    VariableInfo(const std::string& n, const std::string& t, int l, int p)
-        : name(n), type(t), line(l), position(p) {
-    }
-};
-
-//      
-struct ProcedureInfo {
-    std::string name;
-    std::string returnType;  // "void"     
-    int line;
-
-    //   
-    ProcedureInfo() : name(""), returnType(""), line(0) {}
-
-    //   
-    ProcedureInfo(const std::string& n, const std::string& rt, int l)
-        : name(n), returnType(rt), line(l) {
-    }
-};
-
-class SemanticAnalyzer {
-private:
-    std::ofstream& outputFile;
-    std::vector<std::string> errorMessages;
-    bool hasError;
-
-    //  
-    std::unordered_map<std::string, VariableInfo> globalSymbolTable;
-    std::unordered_map<std::string, ProcedureInfo> procedureTable;
-
-    //    
-    std::string currentProcedure;
-    std::unordered_set<std::string> usedVariables;  //    
-    std::unordered_set<std::string> declaredVariables; //  
-
-    //     
-    std::stack<std::string> typeStack;
-
-    //    
-    std::string postfixCode;
-
-    //  
-    void error(const std::string& message, int line, int position);
-    void printErrors();
-
-    //    
-    int labelCounter;
-    std::string generateLabel();
-
-    //     
-    void checkVariableDeclaration(const std::string& varName, int line, int position);
-    void checkVariableUsage(const std::string& varName, int line, int position);
-    void checkTypeCompatibility(const std::string& expected, const std::string& actual,
-        int line, int position, const std::string& context = "");
-
-    //     
-    void traverseProcedure(ParseTreeNode* node);
-    void traverseBegin(ParseTreeNode* node);
-    void traverseDescriptions(ParseTreeNode* node);
-    void traverseDescr(ParseTreeNode* node);
-    void traverseVarList(ParseTreeNode* node, const std::string& type);
-    void traverseOperators(ParseTreeNode* node);
-    void traverseOp(ParseTreeNode* node);
-    void traverseAssignment(ParseTreeNode* node);
-    void traverseIfStatement(ParseTreeNode* node);
-    void traverseExpr(ParseTreeNode* node);
-    void traverseSimpleExpr(ParseTreeNode* node);
-    void traverseCondition(ParseTreeNode* node);
-
-    //     
-    void generatePostfixForExpr(ParseTreeNode* node);
-    void generatePostfixForSimpleExpr(ParseTreeNode* node);
-    void generatePostfixForCondition(ParseTreeNode* node);
-
-public:
-    SemanticAnalyzer(std::ofstream& out);
-    bool analyze(ParseTreeNode* root);
-    void printPostfixCode();
-    bool hasErrors() const { return hasError; }
-};
-
+#ifndef SEMANTICANALYZER_H
+#define SEMANTICANALYZER_H
+
+#include "ParseTreeNode.h"
+#include "ConstantPool.h"
+#include "OpenHashMap.h"
+#include <cstdint>
+#include <vector>
+#include <stack>
+#include <string>
+#include <string_view>
+#include <ostream>
+
+// Структура для хранения информации о переменной
+struct VariableInfo {
+    std::string name;
+    std::string type;
+    std::int64_t line;      // Строка объявления
+    std::int64_t position;  // Позиция в строке
+
+    // Конструктор по умолчанию
+    VariableInfo() : name(""), type(""), line(0), position(0) {}
+
+    // Конструктор с параметрами
+    VariableInfo(const std::string& n, const std::string& t, std::int64_t l, std::int64_t p)
+        : name(n), type(t), line(l), position(p) {
+    }
+};
+
+// Структура для хранения информации о процедуре
+struct ProcedureInfo {
+    std::string name;
+    std::string returnType;  // "void" для процедур без возвращаемого значения
+    std::int64_t line;
+
+    // Конструктор по умолчанию
+    ProcedureInfo() : name(""), returnType(""), line(0) {}
+
+    // Конструктор с параметрами
+    ProcedureInfo(const std::string& n, const std::string& rt, std::int64_t l)
+        : name(n), returnType(rt), line(l) {
+    }
+};
+
+class SemanticAnalyzer {
+private:
+    std::ostream& outputFile;       // куда выводится отчёт (файл, строка или пустой поток)
+    const ConstantPool* constants;  // значения констант (nullptr - берётся текст лексемы)
+    std::vector<std::string> errorMessages;
+    bool hasError;
+
+    // Таблицы символов (поиск по std::string_view, без копирования имени)
+    OpenHashMap<VariableInfo> globalSymbolTable;
+    OpenHashMap<ProcedureInfo> procedureTable;
+
+    // Для отслеживания текущего контекста
+    std::string currentProcedure;
+    OpenHashSet usedVariables;      // Для проверки объявленных переменных
+    OpenHashSet declaredVariables;  // Объявленные переменные
+
+    // Стек для хранения типов выражений
+    std::stack<std::string> typeStack;
+
+    // Для генерации постфиксной записи
+    std::string postfixCode;
+
+    // Вспомогательные методы
+    void error(const std::string& message, std::int64_t line, std::int64_t position);
+    void printErrors();
+
+    // Для меток и переходов
+    int labelCounter;
+    std::string generateLabel();
+
+    // Методы для проверки семантических правил
+    void checkVariableDeclaration(std::string_view varName, std::int64_t line, std::int64_t position);
+    void checkVariableUsage(std::string_view varName, std::int64_t line, std::int64_t position);
+    void checkTypeCompatibility(const std::string& expected, const std::string& actual,
+        std::int64_t line, std::int64_t position, const std::string& context = "");
+
+    // Методы для обхода дерева разбора
+    void traverseProcedure(ParseTreeNode* node);
+    void traverseBegin(ParseTreeNode* node);
+    void traverseDescriptions(ParseTreeNode* node);
+    void traverseDescr(ParseTreeNode* node);
+    void traverseVarList(ParseTreeNode* node, const std::string& type);
+    void traverseOperators(ParseTreeNode* node);
+    void traverseOp(ParseTreeNode* node);
+    void traverseAssignment(ParseTreeNode* node);
+    void traverseIfStatement(ParseTreeNode* node);
+    void traverseExpr(ParseTreeNode* node);
+    void traverseSimpleExpr(ParseTreeNode* node);
+    void traverseCondition(ParseTreeNode* node);
+
+    // Методы для генерации постфиксной записи
+    void generatePostfixForExpr(ParseTreeNode* node);
+    void generatePostfixForSimpleExpr(ParseTreeNode* node);
+    void generatePostfixForCondition(ParseTreeNode* node);
+
+public:
+    SemanticAnalyzer(std::ostream& out, const ConstantPool* constantPool = nullptr);
+    bool analyze(ParseTreeNode* root);
+    // Анализ по частям, по мере готовности дерева: сначала узел Descriptions,
+    // затем операторы по порядку, в конце - вывод результата (как analyze)
+    void analyzeDescriptions(ParseTreeNode* node);
+    void analyzeOperator(ParseTreeNode* node);
+    bool finish();
+    void printPostfixCode();
+    bool hasErrors() const { return hasError; }
+    const std::vector<std::string>& getErrors() const { return errorMessages; }  // сообщения об ошибках
+    const std::string& getPostfixCode() const { return postfixCode; }           // постфиксная запись
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Кольцевая очередь без блокировок для одного писателя и одного читателя.
+// Ёмкость ограничена: писатель, обогнавший читателя на всю очередь, ждёт
+// (это и есть обратное давление между этапами конвейера). Ожидание - уступка
+// процессора (yield), поэтому конвейер не съедает ядро и на одном процессоре.
+template <typename T>
+class SpscRing {
+private:
+    std::vector<T> slots;                 // ячейки (размер - степень двойки)
+    std::size_t mask;                     // размер - 1, для индекса ячейки
+    alignas(64) std::atomic<std::size_t> head;  // номер следующего чтения (меняет читатель)
+    alignas(64) std::atomic<std::size_t> tail;  // номер следующей записи (меняет писатель)
+
+public:
+    explicit SpscRing(std::size_t capacity) : head(0), tail(0) {
+        std::size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Запись без ожидания: false, если очередь полна (item тогда не тронут)
+    bool tryPush(T& item) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == slots.size()) return false;
+        slots[t & mask] = std::move(item);
+        tail.store(t + 1, std::memory_order_release);  // публикуем ячейку читателю
+        return true;
+    }
+
+    // Чтение без ожидания: false, если очередь пуста
+    bool tryPop(T& item) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);  // освобождаем ячейку писателю
+        return true;
+    }
+
+    // Запись и чтение с ожиданием места или данных
+    void push(T item) {
+        while (!tryPush(item)) std::this_thread::yield();
+    }
+
+    T pop() {
+        T item;
+        while (!tryPop(item)) std::this_thread::yield();
+        return item;
+    }
+};
+
+#endif
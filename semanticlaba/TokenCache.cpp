@@ -0,0 +1,250 @@
+#include "TokenCache.h"
+#include "SourceFile.h"
+#include "Keywords.h"
+#include "LexErrors.h"
+#include "StringHash.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+const char CACHE_MAGIC[8] = { 'L', 'A', 'B', 'A', 'T', 'O', 'K', '\0' };
+const std::uint32_t BYTE_ORDER_MARK = 0x01020304;  // в файле с другим порядком байтов читается иначе
+
+// Заголовок файла кэша; за ним идут разделы:
+//   константы       - constantCount значений по 8 байт;
+//   типы            - tokenCount байт;
+//   номера          - idCount номеров по 4 байта (Token::id) только у ID, CONST и ERROR, по порядку;
+//   места лексем    - spanBytes байт: у каждого токена varint промежутка от конца предыдущей
+//                     лексемы и varint длины (обычно по байту на каждое);
+//   имена           - nameBytes байт: у каждого имени (в порядке номеров) varint смещения от
+//                     начала предыдущего имени и varint длины - таблица имён без лексем ID
+struct CacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t sourceHash;     // хеш исходных байтов
+    std::uint64_t sourceSize;     // размер исходных байтов
+    std::uint64_t tokenCount;
+    std::uint64_t constantCount;
+    std::uint64_t idCount;
+    std::uint64_t spanBytes;
+    std::uint64_t nameCount;
+    std::uint64_t nameBytes;
+};
+
+const std::uint64_t SOURCE_HASH_SEED = 0x4C414241544F4B31ull;  // постоянное зерно: ключ хранится в файле
+
+// Есть ли у токена этого типа номер в разделе номеров
+bool hasId(TokenType type) {
+    return type == TokenType::ID || type == TokenType::CONST || type == TokenType::ERROR;
+}
+
+// Беззнаковое число по 7 бит в байте, старший бит - "есть продолжение" (LEB128)
+void appendVarint(std::vector<char>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Чтение varint из [p, end); false - число оборвано или длиннее 64 бит
+bool readVarint(const unsigned char*& p, const unsigned char* end, std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        unsigned char byte = *p++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80) return true;
+    }
+    return false;
+}
+
+}
+
+std::uint64_t TokenCache::hashBytes(const char* begin, const char* end) {
+    return hashString(begin, static_cast<std::size_t>(end - begin), SOURCE_HASH_SEED);
+}
+
+bool TokenCache::load(const std::string& cachePath, const char* sourceBegin, const char* sourceEnd,
+    TokenBuffer& tokens, ConstantPool& constants, OpenHashSet& names) {
+    SourceFile file(cachePath);
+    if (!file.isOpen() || file.length() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, file.begin(), sizeof(header));
+    const std::uint64_t sourceSize = static_cast<std::uint64_t>(sourceEnd - sourceBegin);
+
+    // Заголовок: формат, версия, вход, для которого записан кэш, и размеры разделов
+    if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != VERSION
+        || header.byteOrder != BYTE_ORDER_MARK || header.sourceSize != sourceSize || header.tokenCount == 0) {
+        return false;
+    }
+    const std::uint64_t available = file.length() - sizeof(CacheHeader);
+    const std::uint64_t sections[] = { header.constantCount, header.tokenCount, header.idCount, header.spanBytes, header.nameBytes };
+    for (std::uint64_t section : sections) {
+        if (section > available) return false;  // и от переполнения в сумме ниже
+    }
+    if (header.nameCount > header.nameBytes
+        || header.constantCount * 8 + header.tokenCount + header.idCount * 4 + header.spanBytes + header.nameBytes != available
+        || hashBytes(sourceBegin, sourceEnd) != header.sourceHash) {
+        return false;
+    }
+
+    const char* p = file.begin() + sizeof(CacheHeader);
+    const char* constantData = p;
+    const unsigned char* types = reinterpret_cast<const unsigned char*>(constantData + header.constantCount * 8);
+    const char* idData = reinterpret_cast<const char*>(types + header.tokenCount);
+    const unsigned char* span = reinterpret_cast<const unsigned char*>(idData + header.idCount * 4);
+    const unsigned char* spanEnd = span + header.spanBytes;
+    const unsigned char* name = spanEnd;
+    const unsigned char* nameEnd = name + header.nameBytes;
+
+    // Таблица имён: каждое имя - один раз, номера по порядку
+    OpenHashSet loadedNames;
+    std::uint64_t nameOffset = 0;
+    for (std::uint64_t k = 0; k < header.nameCount; k++) {
+        std::uint64_t delta = 0;
+        std::uint64_t length = 0;
+        if (!readVarint(name, nameEnd, delta) || !readVarint(name, nameEnd, length)
+            || delta > sourceSize - nameOffset || length > sourceSize - nameOffset - delta) {
+            return false;
+        }
+        nameOffset += delta;
+        if (loadedNames.insert(std::string_view(sourceBegin + nameOffset, static_cast<std::size_t>(length))).first != k) {
+            return false;  // повтор имени
+        }
+    }
+    if (name != nameEnd) return false;
+
+    // Столбцы буфера - за один проход по отображённому файлу: типы, места и номера
+    // раскладываются сразу в слова, длины и номера с проверкой границ каждого поля
+    const std::size_t count = static_cast<std::size_t>(header.tokenCount);
+    std::vector<std::uint64_t> words(count);
+    std::vector<std::uint32_t> lengths(count);
+    std::vector<std::uint32_t> ids(count);
+    std::uint64_t end = 0;       // конец предыдущей лексемы
+    std::uint64_t nextId = 0;    // следующий номер в разделе номеров
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint64_t gap = 0;
+        std::uint64_t length = 0;
+        if (types[i] >= TOKEN_TYPE_COUNT || !readVarint(span, spanEnd, gap) || !readVarint(span, spanEnd, length)
+            || gap > sourceSize - end || length > sourceSize - end - gap || length > Token::MAX_LENGTH) {
+            return false;
+        }
+        TokenType type = static_cast<TokenType>(types[i]);
+        std::uint64_t offset = end + gap;
+        end = offset + length;
+
+        std::uint32_t id = Token::NO_ID;
+        if (hasId(type)) {
+            if (nextId == header.idCount) return false;
+            std::memcpy(&id, idData + nextId * 4, 4);
+            nextId++;
+            std::uint64_t limit = type == TokenType::ID ? header.nameCount
+                : type == TokenType::CONST ? header.constantCount : LEX_ERROR_COUNT;
+            if (id >= limit || (type == TokenType::ERROR && id == static_cast<std::uint32_t>(LexError::NONE))) {
+                return false;
+            }
+        }
+        words[i] = Token::pack(type, static_cast<std::size_t>(offset));
+        lengths[i] = static_cast<std::uint32_t>(length);
+        ids[i] = id;
+    }
+    if (span != spanEnd || nextId != header.idCount
+        || static_cast<TokenType>(types[count - 1]) != TokenType::END_OF_FILE) {
+        return false;
+    }
+
+    // Кэш цел - переносим данные
+    tokens.words.swap(words);
+    tokens.lengths.swap(lengths);
+    tokens.ids.swap(ids);
+    constants.reserve(static_cast<std::size_t>(header.constantCount));
+    for (std::uint64_t k = 0; k < header.constantCount; k++) {
+        std::int64_t value;
+        std::memcpy(&value, constantData + k * 8, 8);
+        constants.intern(value);
+    }
+    names = std::move(loadedNames);
+    return true;
+}
+
+bool TokenCache::save(const std::string& cachePath, const char* sourceBegin, const char* sourceEnd,
+    const TokenBuffer& tokens, const ConstantPool& constants) {
+    // Кэшируются только буферы с исходными байтами
+    if (!tokens.source || tokens.empty()) return false;
+
+    const std::size_t count = tokens.size();
+    std::vector<char> data;
+    data.reserve(constants.size() * 8 + count * 5);
+    for (std::size_t k = 0; k < constants.size(); k++) {
+        std::int64_t value = constants.value(k);
+        data.insert(data.end(), reinterpret_cast<const char*>(&value), reinterpret_cast<const char*>(&value) + 8);
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        data.push_back(static_cast<char>(tokens.type(i)));
+    }
+    std::uint64_t idCount = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        if (hasId(tokens.type(i))) {
+            std::uint32_t id = tokens.id(i);
+            data.insert(data.end(), reinterpret_cast<const char*>(&id), reinterpret_cast<const char*>(&id) + 4);
+            idCount++;
+        }
+    }
+    const std::size_t spanStart = data.size();
+    std::uint64_t end = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        std::uint64_t offset = tokens.offset(i);
+        if (offset < end) return false;  // лексемы не по порядку - такой буфер не кэшируется
+        appendVarint(data, offset - end);
+        appendVarint(data, tokens.length(i));
+        end = offset + tokens.length(i);
+    }
+    // Имена - по первым вхождениям лексем ID: лексер нумерует имена в порядке появления
+    const std::size_t nameStart = data.size();
+    std::uint64_t nameCount = 0;
+    std::uint64_t nameOffset = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        if (tokens.type(i) != TokenType::ID || tokens.id(i) < nameCount) continue;
+        if (tokens.id(i) != nameCount) return false;  // нумерация не по порядку появления
+        appendVarint(data, tokens.offset(i) - nameOffset);
+        appendVarint(data, tokens.length(i));
+        nameOffset = tokens.offset(i);
+        nameCount++;
+    }
+    CacheHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.sourceHash = hashBytes(sourceBegin, sourceEnd);
+    header.sourceSize = static_cast<std::uint64_t>(sourceEnd - sourceBegin);
+    header.tokenCount = count;
+    header.constantCount = constants.size();
+    header.idCount = idCount;
+    header.spanBytes = nameStart - spanStart;
+    header.nameCount = nameCount;
+    header.nameBytes = data.size() - nameStart;
+    std::string tempPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            out.close();
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::remove(cachePath.c_str());  // rename в Windows не заменяет существующий файл
+    if (std::rename(tempPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
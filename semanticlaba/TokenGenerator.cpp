@@ -0,0 +1,34 @@
+#include "TokenGenerator.h"
+
+#ifdef TOKEN_COROUTINES
+
+#include "Lexer.h"
+
+TokenGenerator generateTokens(Lexer& lexer) {
+    for (;;) {
+        Token token = lexer.getNextToken();
+        co_yield token;
+        if (token.type() == TokenType::END_OF_FILE) co_return;
+    }
+}
+
+GeneratorTokenStream::GeneratorTokenStream(Lexer& source)
+    : lexer(source), generator(generateTokens(source)), where{ 1, 1 } {}
+
+Token GeneratorTokenStream::next() {
+    if (generator.resume()) {
+        current = generator.token();
+        where = lexer.location(current);
+    }
+    return current;  // после END_OF_FILE сопрограмма завершена - снова END_OF_FILE
+}
+
+std::string_view GeneratorTokenStream::text() {
+    std::string_view lexeme = lexer.lexeme(current);
+    if (!lexer.isStream() || lexeme.empty()) {
+        return lexeme;
+    }
+    return texts.key(texts.insert(lexeme).first);
+}
+
+#endif
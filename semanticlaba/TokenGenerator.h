@@ -0,0 +1,88 @@
+#pragma once
+#ifndef TOKENGENERATOR_H
+#define TOKENGENERATOR_H
+
+// Генератор токенов на сопрограмме C++20. Собирается только при компиляции как C++20
+// (g++ -std=c++20, MSVC /std:c++20) - тогда определён TOKEN_COROUTINES; в C++17 файл пуст,
+// и парсер получает токены через LexerTokenStream.
+#if defined(__has_include)
+#if __has_include(<coroutine>) && ((defined(_MSVC_LANG) && _MSVC_LANG >= 202002L) || __cplusplus >= 202002L)
+#define TOKEN_COROUTINES 1
+#endif
+#endif
+
+#ifdef TOKEN_COROUTINES
+
+#include "Token.h"
+#include "TokenStream.h"
+#include "OpenHashMap.h"
+#include <coroutine>
+#include <exception>
+#include <string_view>
+
+class Lexer;
+
+// Сопрограмма, которая выдаёт токены через co_yield и приостанавливается до запроса
+// следующего. Исключение из лексера передаётся вызывающему в resume().
+class TokenGenerator {
+public:
+    struct promise_type {
+        Token current;
+        std::exception_ptr error;
+
+        TokenGenerator get_return_object() { return TokenGenerator(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }  // первый токен - по первому запросу
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const Token& token) noexcept {
+            current = token;
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { error = std::current_exception(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    TokenGenerator(TokenGenerator&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    TokenGenerator(const TokenGenerator&) = delete;
+    TokenGenerator& operator=(const TokenGenerator&) = delete;
+    ~TokenGenerator() {
+        if (handle) handle.destroy();
+    }
+
+    // Продолжение сопрограммы до следующего токена; false - сопрограмма завершилась
+    bool resume() {
+        if (!handle || handle.done()) return false;
+        handle.resume();
+        if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+        return !handle.done();
+    }
+    const Token& token() const { return handle.promise().current; }
+
+private:
+    Handle handle;
+
+    explicit TokenGenerator(Handle h) : handle(h) {}
+};
+
+// Токены лексера до END_OF_FILE включительно
+TokenGenerator generateTokens(Lexer& lexer);
+
+// Источник токенов для парсера поверх генератора (аналог LexerTokenStream)
+class GeneratorTokenStream final : public TokenStream {
+private:
+    Lexer& lexer;
+    TokenGenerator generator;
+    Token current;             // последний выданный токен
+    SourceLocation where;      // его место
+    OpenHashSet texts;         // тексты лексем потокового входа (см. LexerTokenStream)
+
+public:
+    explicit GeneratorTokenStream(Lexer& source);
+    Token next() override;
+    SourceLocation location() const override { return where; }
+    std::string_view text() override;
+};
+
+#endif
+
+#endif
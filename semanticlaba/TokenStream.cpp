@@ -0,0 +1,18 @@
+#include "TokenStream.h"
+#include "Lexer.h"
+
+LexerTokenStream::LexerTokenStream(Lexer& source) : lexer(source), where{ 1, 1 } {}
+
+Token LexerTokenStream::next() {
+    current = lexer.getNextToken();
+    where = lexer.location(current);
+    return current;
+}
+
+std::string_view LexerTokenStream::text() {
+    std::string_view lexeme = lexer.lexeme(current);
+    if (!lexer.isStream() || lexeme.empty()) {
+        return lexeme;  // вид на входные байты лексера
+    }
+    return texts.key(texts.insert(lexeme).first);
+}
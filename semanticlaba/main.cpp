@@ -1,126 +1,99 @@
-#include "Lexer.h"
-#include "Parser.h"
-#include "SemanticAnalyzer.h"
-#include <iostream>
-#include <windows.h>
-#include <fstream>
-
-int main() {
-    SetConsoleOutputCP(1251);
-
-    std::string inputFile = "input.txt";
-    std::string outputFile = "output.txt";
-
-    std::cout << " ..." << std::endl;
-
-    //   
-    std::ofstream clearFile(outputFile);
-    clearFile.close();
-
-    //  
-    std::cout << " ..." << std::endl;
-    Lexer lexer1(inputFile, outputFile);
-    lexer1.analyze();
-
-    if (lexer1.hasErrors()) {
-        std::cout << "    ." << std::endl;
-    }
-    else {
-        std::cout << "   ." << std::endl;
-    }
-
-    //   
-    std::cout << " ..." << std::endl;
-
-    std::ofstream outFile(outputFile, std::ios::app);
-    if (!outFile.is_open()) {
-        std::cerr << "      " << std::endl;
-        return 1;
-    }
-
-    //      
-    Lexer parserLexer(inputFile, "temp.txt");
-    Parser parser(parserLexer, outFile);
-    bool parseSuccess = parser.parse();
-
-    outFile.close();
-
-    //  
-    bool semanticSuccess = false;
-
-    if (parseSuccess && !lexer1.hasErrors()) {
-        std::cout << " ..." << std::endl;
-
-        //       
-        std::ofstream semOutFile(outputFile, std::ios::app);
-        if (!semOutFile.is_open()) {
-            std::cerr << "       " << std::endl;
-            return 1;
-        }
-
-
-        //         
-        Lexer semanticLexer(inputFile, "temp_sem.txt");
-
-        //  ,    
-        std::ofstream parserTempOut("parser_sem_temp.txt");
-        Parser semanticParser(semanticLexer, parserTempOut);
-
-        //     
-        semanticParser.parseForSemantic();
-
-        //   
-        ParseTreeNode* root = semanticParser.getParseTree();
-
-        if (root) {
-            //     
-            SemanticAnalyzer semanticAnalyzer(semOutFile);
-            semanticSuccess = semanticAnalyzer.analyze(root);
-
-            //   
-            delete root;
-        }
-        else {
-            semOutFile << "\n:        \n";
-            semanticSuccess = false;
-        }
-
-        semOutFile.close();
-        parserTempOut.close();
-
-        //   
-        remove("temp.txt");
-        remove("temp_sem.txt");
-        remove("parser_sem_temp.txt");
-
-        if (semanticSuccess) {
-            std::cout << "   ." << std::endl;
-        }
-        else {
-            std::cout << "    ." << std::endl;
-        }
-    }
-    else {
-        std::cout << "   -    ." << std::endl;
-    }
-
-    // ===   ===
-    std::cout << "\n===   ===" << std::endl;
-    std::cout << " : "
-        << (lexer1.hasErrors() ? "" : "") << std::endl;
-    std::cout << " : "
-        << (parseSuccess ? "" : "") << std::endl;
-    std::cout << " : "
-        << (semanticSuccess ? "" : "/") << std::endl;
-
-    bool overallSuccess = !lexer1.hasErrors() && parseSuccess && semanticSuccess;
-
-    std::cout << "\n : "
-        << (overallSuccess ? "  " : "   ")
-        << std::endl;
-
-    std::cout << "\n    : " << outputFile << std::endl;
-
-    system("pause");
-    return overallSuccess ? 0 : 1;
+#include "Lexer.h"
+#include "Parser.h"
+#include "SemanticAnalyzer.h"
+#include <iostream>
+#include <thread>
+#include <windows.h>
+#include <ostream>
+
+int main() {
+    SetConsoleOutputCP(1251);
+
+    std::string inputFile = "input.txt";
+    std::string outputFile = "output.txt";
+
+    std::cout << "Запуск анализатора..." << std::endl;
+
+    // Один выходной файл на все этапы: лексер, парсер и семантический анализатор пишут
+    // в общий буфер, файл создаётся заново
+    OutputSink output(outputFile);
+    if (!output.isOpen()) {
+        std::cerr << "Не удалось открыть выходной файл: " << outputFile << std::endl;
+        return 1;
+    }
+    std::ostream outFile(&output);  // тот же буфер для вывода через std::ostream
+
+    // ЛЕКСИЧЕСКИЙ АНАЛИЗ
+    std::cout << "Лексический анализ..." << std::endl;
+    // Вход разбирается один раз: те же токены идут в таблицу лексем и в парсер
+    Lexer lexer1(inputFile, output);
+    // Большие файлы разбираются параллельно; токены неизменного входа от 1 МБ - из кэша input.txt.tok
+    unsigned threads = std::thread::hardware_concurrency();
+    TokenBuffer tokens = lexer1.tokenizeCached(inputFile + ".tok", threads);
+    lexer1.report(tokens, threads);
+
+    if (lexer1.hasErrors()) {
+        std::cout << "Лексический анализ завершен с ошибками." << std::endl;
+    }
+    else {
+        std::cout << "Лексический анализ завершен успешно." << std::endl;
+    }
+
+    // СИНТАКСИЧЕСКИЙ АНАЛИЗ 
+    std::cout << "Синтаксический анализ..." << std::endl;
+
+    // Парсер идёт по уже разобранным токенам; дерево сохраняется для семантического анализа
+    Parser parser(tokens, outFile);
+    bool parseSuccess = parser.parse();
+    ParseTreeNode* root = parser.getParseTree();
+
+    // СЕМАНТИЧЕСКИЙ АНАЛИЗ
+    bool semanticSuccess = false;
+
+    if (parseSuccess && !lexer1.hasErrors()) {
+        std::cout << "Семантический анализ..." << std::endl;
+
+        // Семантический анализ того же дерева разбора
+        if (root) {
+            SemanticAnalyzer semanticAnalyzer(outFile, &lexer1.constants());
+            semanticSuccess = semanticAnalyzer.analyze(root);
+        }
+        else {
+            outFile << "\nОшибка: не удалось построить дерево разбора для семантического анализа\n";
+            semanticSuccess = false;
+        }
+
+        if (semanticSuccess) {
+            std::cout << "Семантический анализ завершен успешно." << std::endl;
+        }
+        else {
+            std::cout << "Семантический анализ завершен с ошибками." << std::endl;
+        }
+    }
+    else {
+        std::cout << "Семантический анализ пропущен из-за ошибок на предыдущих этапах." << std::endl;
+    }
+
+    delete root;  // дерево разбора больше не нужно
+
+    // === ИТОГОВЫЙ РЕЗУЛЬТАТ ===
+    std::cout << "\n=== ИТОГИ АНАЛИЗА ===" << std::endl;
+    std::cout << "Лексический анализ: "
+        << (lexer1.hasErrors() ? "ОШИБКИ" : "УСПЕХ") << std::endl;
+    std::cout << "Синтаксический анализ: "
+        << (parseSuccess ? "УСПЕХ" : "ОШИБКИ") << std::endl;
+    std::cout << "Семантический анализ: "
+        << (semanticSuccess ? "УСПЕХ" : "ОШИБКИ/ПРОПУЩЕН") << std::endl;
+
+    bool overallSuccess = !lexer1.hasErrors() && parseSuccess && semanticSuccess;
+
+    std::cout << "\nОБЩИЙ РЕЗУЛЬТАТ: "
+        << (overallSuccess ? "АНАЛИЗ ПРОГРАММЫ УСПЕШЕН" : "АНАЛИЗ ЗАВЕРШЕН С ОШИБКАМИ")
+        << std::endl;
+
+    std::cout << "\nПодробные результаты сохранены в файле: " << outputFile << std::endl;
+
+    output.flush();  // результаты - в файл до паузы
+    system("pause");
+    return overallSuccess ? 0 : 1;
 }
\ No newline at end of file
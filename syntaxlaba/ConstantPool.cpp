@@ -0,0 +1,55 @@
+#include "ConstantPool.h"
+#include <stdexcept>
+
+const std::uint32_t ConstantPool::EMPTY;
+
+ConstantPool::ConstantPool() : slots(std::size_t(1) << INITIAL_BITS, EMPTY), shift(64 - INITIAL_BITS) {
+}
+
+// Мультипликативный хеш (Фибоначчи): близкие значения попадают в далёкие ячейки
+std::size_t ConstantPool::slotOf(std::int64_t value) const {
+    std::size_t mask = slots.size() - 1;
+    std::size_t pos = static_cast<std::size_t>((static_cast<std::uint64_t>(value) * 0x9E3779B97F4A7C15ull) >> shift);
+    while (slots[pos] != EMPTY && values[slots[pos]] != value) {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+void ConstantPool::rebuild(int bits) {
+    slots.assign(std::size_t(1) << bits, EMPTY);
+    shift = 64 - bits;
+    for (std::size_t i = 0; i < values.size(); i++) {
+        slots[slotOf(values[i])] = static_cast<std::uint32_t>(i);
+    }
+}
+
+std::uint32_t ConstantPool::intern(std::int64_t value) {
+    std::size_t pos = slotOf(value);
+    if (slots[pos] != EMPTY) {
+        return slots[pos];  // такая константа уже есть
+    }
+    if (values.size() >= EMPTY) {
+        throw std::length_error("ConstantPool: больше 2^32 констант");
+    }
+    std::uint32_t index = static_cast<std::uint32_t>(values.size());
+    values.push_back(value);
+    if (values.size() * 2 > slots.size()) {
+        rebuild(64 - shift + 1);  // заполнена больше чем наполовину - удваиваем
+    }
+    else {
+        slots[pos] = index;
+    }
+    return index;
+}
+
+void ConstantPool::reserve(std::size_t expected) {
+    values.reserve(expected);
+    int bits = 64 - shift;
+    while ((std::size_t(1) << bits) < expected * 2) {
+        bits++;
+    }
+    if (bits != 64 - shift) {
+        rebuild(bits);
+    }
+}
@@ -1,102 +1,26 @@
-#include "HashTable.h"
-#include <fstream>
-#include <iostream>
-
-HashTable::HashTable() : currentIndex(0) {
-    table = new HashEntry[TABLE_SIZE];
-}
-
-HashTable::~HashTable() {
-    delete[] table;
-}
-
-// - -     
-int HashTable::hashFunction(const std::string& key) {
-    int hash = 0;
-    //     
-    for (char c : key) {
-        hash = (hash * 31 + c) % TABLE_SIZE;  //    ,   :    ""   (          31)
-    }
-    return hash;
-}
-
-//    (  )
-int HashTable::findEmptySlot(const std::string& key) {
-    int index = hashFunction(key);  //    -
-    int originalIndex = index;      //   
-
-    //         
-    while (table[index].occupied && table[index].token.value != key) {
-        index = (index + 1) % TABLE_SIZE;  //    
-        if (index == originalIndex) {
-            return -1;  //   
-        }
-    }
-    return index;
-}
-
-//    
-int HashTable::insert(const Token& token) {
-    // ,    
-    if (currentIndex >= TABLE_SIZE) {
-        return -1;
-    }
-
-    //   
-    int index = findEmptySlot(token.value);
-    if (index == -1) {
-        return -1;  //    
-    }
-
-    //   ,  
-    if (!table[index].occupied) {
-        table[index].token = token;      //  
-        table[index].index = currentIndex; //  
-        table[index].occupied = true;    //   
-        currentIndex++;                  //  
-    }
-
-    return table[index].index;  //    
-}
-
-//    
-int HashTable::find(const std::string& value) {
-    int index = hashFunction(value);  //   
-    int originalIndex = index;        //   
-
-    //    
-    while (table[index].occupied) {
-        if (table[index].token.value == value) {
-            return table[index].index;  //  -  
-        }
-        index = (index + 1) % TABLE_SIZE;  //    
-        if (index == originalIndex) {
-            break;  //   
-        }
-    }
-    return -1;  //  
-}
-
-//  -  
-void HashTable::printToFile(const std::string& filename) {
-    std::ofstream outFile(filename, std::ios::app);  //    
-    if (!outFile.is_open()) {
-        std::cerr << "    !" << std::endl;
-        return;
-    }
-
-    outFile << "\n-:\n";
-    outFile << "  |  |   -\n";
-    outFile << "--------------------------------------------\n";
-
-    //    
-    for (int i = 0; i < TABLE_SIZE; i++) {
-        if (table[i].occupied) {
-            outFile << static_cast<int>(table[i].token.type) << " | "
-                << table[i].token.value << " | "
-                << table[i].index << std::endl;
-        }
-    }
-
-    outFile.close();
-}
\ No newline at end of file
+#include "HashTable.h"
+
+// Добавление лексемы: индекс уже известной лексемы или индекс новой
+std::int64_t HashTable::insert(TokenType type, std::string_view value) {
+    return static_cast<std::int64_t>(lexemes.insert(value, type).first);
+}
+
+// Поиск токена по значению (-1 - лексемы нет)
+std::int64_t HashTable::find(std::string_view value) const {
+    std::size_t index = lexemes.indexOf(value);
+    return index != OpenHashMap<TokenType>::NPOS ? static_cast<std::int64_t>(index) : -1;
+}
+
+// Вывод хеш-таблицы в выходной файл: лексемы уже лежат в порядке индексов
+void HashTable::writeTo(OutputSink& out) {
+    out << "\nХеш-таблица:\n";
+    out << "Тип лексемы | Лексема | Индекс в хеш-таблице\n";
+    out << "--------------------------------------------\n";
+
+    for (std::size_t i = 0; i < lexemes.size(); i++) {
+        std::string_view text = lexemes.key(i);
+        out << static_cast<int>(lexemes.value(i)) << " | ";
+        out.put(text.data(), text.size());
+        out << " | " << static_cast<std::uint64_t>(i) << '\n';
+    }
+}
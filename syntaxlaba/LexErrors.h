@@ -0,0 +1,62 @@
+#pragma once
+#ifndef LEXERRORS_H
+#define LEXERRORS_H
+
+#include "Token.h"
+#include "LineIndex.h"
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+
+// Описание лексической ошибки: текст сообщения и признак ошибочного идентификатора
+struct LexErrorInfo {
+    LexError error;
+    const char* message;
+    bool badIdentifier;   // парсер разбирает такой токен на месте id
+};
+
+// Каталог сообщений в порядке перечисления LexError.
+// Лексер хранит в токене только вид ошибки, текст берётся отсюда при выводе.
+constexpr LexErrorInfo LEX_ERRORS[] = {
+    { LexError::NONE,                "",                                           false },
+    { LexError::INVALID_CHAR,        "Недопустимый символ",                        false },
+    { LexError::NUMBER_LEADING_ZERO, "Число не может начинаться с 0",              false },
+    { LexError::NUMBER_OVERFLOW,     "Число слишком велико",                       false },
+    { LexError::ID_BAD_START,        "Идентификатор должен начинаться с буквы",    true },
+    { LexError::ID_HAS_DIGITS,       "Идентификатор не может содержать цифры",     true },
+    { LexError::ID_HAS_UNDERSCORE,   "Идентификатор не может содержать символ '_'", true },
+};
+
+constexpr std::size_t LEX_ERROR_COUNT = sizeof(LEX_ERRORS) / sizeof(LEX_ERRORS[0]);
+
+// Проверка порядка строк и того, что ошибки идентификаторов идут последними
+constexpr bool lexErrorTableValid() {
+    for (std::size_t i = 0; i < LEX_ERROR_COUNT; i++) {
+        if (static_cast<std::size_t>(LEX_ERRORS[i].error) != i) return false;
+        if (LEX_ERRORS[i].badIdentifier != (LEX_ERRORS[i].error >= LexError::ID_BAD_START)) return false;
+    }
+    return true;
+}
+static_assert(lexErrorTableValid(), "LEX_ERRORS должна идти в порядке LexError, ошибки идентификаторов - последними");
+static_assert(LEX_ERROR_COUNT == static_cast<std::size_t>(LexError::ID_HAS_UNDERSCORE) + 1, "в LEX_ERRORS описаны не все ошибки");
+
+// Текст сообщения об ошибке для вывода
+inline const char* lexErrorMessage(LexError error) {
+    std::size_t index = static_cast<std::size_t>(error);
+    return index < LEX_ERROR_COUNT ? LEX_ERRORS[index].message : "";
+}
+
+// Сообщение об ошибке токена в том виде, в каком его выводит лексер: место и текст
+// лексемы берутся у лексера или буфера токенов (out - std::ostream или OutputSink)
+template <typename Output>
+inline void writeLexError(Output& out, SourceLocation where, std::string_view text, LexError error) {
+    out << "ОШИБКА в строке " << where.line << ", позиция " << where.position
+        << ": " << text << " - " << lexErrorMessage(error);
+}
+
+// Ошибочный идентификатор - одно сравнение
+inline bool isBadIdentifier(LexError error) {
+    return error >= LexError::ID_BAD_START;
+}
+
+#endif
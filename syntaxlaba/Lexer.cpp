@@ -1,302 +1,582 @@
-#include "Lexer.h"
-#include <cctype>
-#include <iostream>
-
-//  -     
-Lexer::Lexer(const std::string& inputFilename, const std::string& outputFilename)
-    : line(1), position(1), hasError(false) {
-
-    //   
-    inputFile.open(inputFilename);
-    if (!inputFile.is_open()) {
-        std::cerr << "    : " << inputFilename << std::endl;
-        hasError = true;
-    }
-
-    //   
-    outputFile.open(outputFilename);
-    if (!outputFile.is_open()) {
-        std::cerr << "    : " << outputFilename << std::endl;
-        hasError = true;
-    }
-
-    //   ,   
-    if (inputFile.is_open()) {
-        inputFile.get(currentChar);
-    }
-}
-
-Lexer::~Lexer() {
-    if (inputFile.is_open()) inputFile.close();
-    if (outputFile.is_open()) outputFile.close();
-}
-
-//     
-void Lexer::nextChar() {
-    if (inputFile.get(currentChar)) {
-        position++;  //  
-    }
-    else {
-        currentChar = '\0';  //  
-    }
-}
-
-//  ,    
-void Lexer::skipWhitespace() {
-    while (std::isspace(currentChar)) {
-        if (currentChar == '\n') {
-            line++;     //   
-            position = 1; //  
-        }
-        nextChar();  //   
-    }
-}
-
-//     
-Token Lexer::parseIdentifier() {
-    std::string value;        //   
-    int startLine = line;     //   
-    int startPos = position;  //   
-
-    //      
-    if (std::isalpha(currentChar)) {
-        value += currentChar;
-        nextChar();
-    }
-    else {
-        std::string errorChar(1, currentChar);
-        nextChar();
-        Token errorToken(TokenType::ERROR, errorChar, startLine, startPos);
-        errorToken.errorMessage = "    ";
-        return errorToken;
-    }
-
-    //   
-    while (std::isalpha(currentChar)) {
-        value += currentChar;  //    
-        nextChar();           //   
-    }
-
-    //      -   (  )
-    if (std::isdigit(currentChar)) {
-        //         
-        while (std::isalnum(currentChar)) {
-            value += currentChar;
-            nextChar();
-        }
-        Token errorToken(TokenType::ERROR, value, startLine, startPos);
-        errorToken.errorMessage = "    ";
-        return errorToken;
-    }
-
-    //     _ -  
-    if (currentChar == '_') {
-        value += currentChar;
-        nextChar();
-        Token errorToken(TokenType::ERROR, value, startLine, startPos);
-        errorToken.errorMessage = "     '_'";
-        return errorToken;
-    }
-
-    // ,      
-    if (value == "procedure") return Token(TokenType::PROCEDURE, value, startLine, startPos);
-    if (value == "begin") return Token(TokenType::BEGIN, value, startLine, startPos);
-    if (value == "end") return Token(TokenType::END, value, startLine, startPos);
-    if (value == "var") return Token(TokenType::VAR, value, startLine, startPos);
-    if (value == "integer") return Token(TokenType::INTEGER, value, startLine, startPos);
-    if (value == "if") return Token(TokenType::IF, value, startLine, startPos);
-    if (value == "then") return Token(TokenType::THEN, value, startLine, startPos);
-    if (value == "else") return Token(TokenType::ELSE, value, startLine, startPos);
-
-    //    ,   
-    return Token(TokenType::ID, value, startLine, startPos);
-}
-
-//   
-Token Lexer::parseNumber() {
-    std::string value;        //  
-    int startLine = line;     //   
-    int startPos = position;  //   
-
-    //   ,    
-    while (std::isdigit(currentChar)) {
-        value += currentChar;  //  
-        nextChar();           //   
-    }
-
-    // ,      0 (  0)
-    if (value.length() > 1 && value[0] == '0') {
-        Token errorToken(TokenType::ERROR, value, startLine, startPos);
-        errorToken.errorMessage = "     0";
-        return errorToken;
-    }
-
-    return Token(TokenType::CONST, value, startLine, startPos);
-}
-
-//    
-Token Lexer::parseOperator() {
-    int startLine = line;     //   
-    int startPos = position;  //   
-    Token token;              //    
-
-    //   
-    switch (currentChar) {
-    case ':':  //   :  :=
-        nextChar();  //   
-        if (currentChar == '=') {
-            nextChar();  //    
-            token = Token(TokenType::ASSIGN, ":=", startLine, startPos);
-        }
-        else {
-            token = Token(TokenType::COLON, ":", startLine, startPos);
-        }
-        break;
-
-    case ';':  //   
-        nextChar();
-        token = Token(TokenType::SEMICOLON, ";", startLine, startPos);
-        break;
-    case ',':  // 
-        nextChar();
-        token = Token(TokenType::COMMA, ",", startLine, startPos);
-        break;
-    case '(':  //  
-        nextChar();
-        token = Token(TokenType::LPAREN, "(", startLine, startPos);
-        break;
-    case ')':  //  
-        nextChar();
-        token = Token(TokenType::RPAREN, ")", startLine, startPos);
-        break;
-    case '+':  // 
-        nextChar();
-        token = Token(TokenType::PLUS, "+", startLine, startPos);
-        break;
-    case '-':  // 
-        nextChar();
-        token = Token(TokenType::MINUS, "-", startLine, startPos);
-        break;
-    case '=':  // 
-        nextChar();
-        token = Token(TokenType::EQUAL, "=", startLine, startPos);
-        break;
-    case '>':  // 
-        nextChar();
-        token = Token(TokenType::GREATER, ">", startLine, startPos);
-        break;
-    case '<':  //   <  <>
-        nextChar();
-        if (currentChar == '>') {
-            nextChar();
-            token = Token(TokenType::NOT_EQUAL, "<>", startLine, startPos);
-        }
-        else {
-            token = Token(TokenType::LESS, "<", startLine, startPos);
-        }
-        break;
-
-    default:  //  
-        std::string errorChar(1, currentChar);  //     
-        nextChar();
-        token = Token(TokenType::ERROR, errorChar, startLine, startPos);
-        break;
-    }
-
-    return token;
-}
-
-//       
-std::string Lexer::tokenTypeToString(TokenType type) {
-    switch (type) {
-    case TokenType::PROCEDURE: return "PROCEDURE";
-    case TokenType::BEGIN: return "BEGIN";
-    case TokenType::END: return "END";
-    case TokenType::VAR: return "VAR";
-    case TokenType::INTEGER: return "INTEGER";
-    case TokenType::IF: return "IF";
-    case TokenType::THEN: return "THEN";
-    case TokenType::ELSE: return "ELSE";
-    case TokenType::ID: return "ID";
-    case TokenType::CONST: return "CONST";
-    case TokenType::ASSIGN: return "ASSIGN";
-    case TokenType::PLUS: return "PLUS";
-    case TokenType::MINUS: return "MINUS";
-    case TokenType::EQUAL: return "EQUAL";
-    case TokenType::NOT_EQUAL: return "NOT_EQUAL";
-    case TokenType::GREATER: return "GREATER";
-    case TokenType::LESS: return "LESS";
-    case TokenType::SEMICOLON: return "SEMICOLON";
-    case TokenType::COLON: return "COLON";
-    case TokenType::COMMA: return "COMMA";
-    case TokenType::LPAREN: return "LPAREN";
-    case TokenType::RPAREN: return "RPAREN";
-    case TokenType::END_OF_FILE: return "END_OF_FILE";
-    case TokenType::ERROR: return "ERROR";
-    default: return "UNKNOWN";
-    }
-}
-
-//   -   
-Token Lexer::getNextToken() {
-    skipWhitespace();  //  
-
-    //   
-    if (currentChar == '\0') {
-        return Token(TokenType::END_OF_FILE, "", line, position);
-    }
-
-    //      
-    if (std::isalpha(currentChar) || currentChar == '_') {
-        return parseIdentifier();  //    
-    }
-
-    if (std::isdigit(currentChar)) {
-        return parseNumber();      //  
-    }
-
-    return parseOperator();        //   
-}
-
-//    -   
-void Lexer::analyze() {
-    if (!outputFile.is_open()) return; // ,   
-
-    //   
-    outputFile << "  :\n";
-    outputFile << " |  |  | \n";
-    outputFile << "---------------------------------\n";
-
-    Token token; //     
-    //    -     
-    do {
-        token = getNextToken(); //   
-
-        if (token.type != TokenType::END_OF_FILE) {
-            outputFile << token.line << " | " << token.position << " | "
-                << tokenTypeToString(token.type) << " | " << token.value << std::endl;
-        }
-
-        //  
-        if (token.type == TokenType::ERROR) {
-            outputFile << "   " << token.line << ",  " << token.position
-                << ": " << token.value;
-            //     ,  
-            if (!token.errorMessage.empty()) {
-                outputFile << " - " << token.errorMessage;
-            }
-            else {
-                outputFile << " -  ";
-            }
-            outputFile << std::endl;
-            hasError = true;
-        }
-        else if (token.type != TokenType::END_OF_FILE) {
-            //    - (    )
-            hashTable.insert(token);
-        }
-
-    } while (token.type != TokenType::END_OF_FILE); //    
-
-    hashTable.printToFile("output.txt"); //  -  
-}
\ No newline at end of file
+#include "Lexer.h"
+#include "CharScan.h"
+#include "Keywords.h"
+#include "OperatorDfa.h"
+#include "LexErrors.h"
+#include "TokenCache.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+// Конструктор - открывает файлы и инициализирует состояние
+Lexer::Lexer(const std::string& inputFilename, const std::string& outputFilename)
+    : inputFile(inputFilename), lineIndex(inputFile.begin(), inputFile.end()), output(nullptr), hasError(false) {
+
+    // Проверяем входной файл (он уже отображён в память)
+    if (!inputFile.isOpen()) {
+        std::cerr << "Не удалось открыть входной файл: " << inputFilename << std::endl;
+        hasError = true;
+    }
+
+    if (!outputFilename.empty()) {
+        openOutput(outputFilename);  // пустое имя - лексер без выходного файла
+    }
+
+    // Встаём на первый символ (пустой или неоткрытый файл - сразу конец)
+    inputBegin = inputFile.begin();
+    baseOffset = 0;
+    cursor = inputBegin;
+    inputEnd = inputFile.end();
+    currentChar = cursor < inputEnd ? *cursor : '\0';
+    scanner.reset(inputEnd);
+    constantPool.reserve(expectedConstants(inputFile.length()));
+}
+
+// Конструктор с общим выходным файлом: таблица лексем и хеш-таблица пишутся в sharedOutput,
+// следом за ними туда же пишут парсер и семантический анализатор
+Lexer::Lexer(const std::string& inputFilename, OutputSink& sharedOutput)
+    : Lexer(inputFilename, std::string()) {
+    output = &sharedOutput;
+}
+
+// Конструктор для байтов в памяти: выходного файла нет, токены берутся
+// через getNextToken()/tokenize()
+Lexer::Lexer(const char* sourceBytes, std::size_t sourceSize)
+    : inputFile(sourceBytes, sourceSize), lineIndex(inputFile.begin(), inputFile.end()), output(nullptr), hasError(false) {
+    inputBegin = inputFile.begin();
+    baseOffset = 0;
+    cursor = inputBegin;
+    inputEnd = inputFile.end();
+    currentChar = cursor < inputEnd ? *cursor : '\0';
+    scanner.reset(inputEnd);
+    constantPool.reserve(expectedConstants(inputFile.length()));
+}
+
+// Конструктор для потокового входа: байты читаются из дескриптора блоками,
+// память не зависит от длины входа
+Lexer::Lexer(int inputFd, const std::string& outputFilename)
+    : streamSource(inputFd), output(nullptr), hasError(false) {
+
+    if (!streamSource.isOpen()) {
+        std::cerr << "Не удалось открыть входной поток: " << inputFd << std::endl;
+        hasError = true;
+    }
+
+    if (!outputFilename.empty()) {
+        openOutput(outputFilename);  // пустое имя - лексер без выходного файла
+    }
+
+    // Встаём на первый символ первого окна
+    streamSource.next(0);
+    inputBegin = streamSource.begin();
+    baseOffset = streamSource.offset();
+    cursor = inputBegin;
+    inputEnd = streamSource.end();
+    currentChar = cursor < inputEnd ? *cursor : '\0';
+    scanner.reset(inputEnd);
+}
+
+// Конструктор для куска входа: файлы не открываются, разбор идёт по чужим байтам
+Lexer::Lexer(const char* origin, const char* begin, const char* end)
+    : output(nullptr), inputBegin(origin), baseOffset(0), cursor(begin), inputEnd(end), hasError(false) {
+    currentChar = cursor < inputEnd ? *cursor : '\0';
+    scanner.reset(inputEnd);
+    constantPool.reserve(expectedConstants(static_cast<std::size_t>(end - begin)));
+}
+
+// Оценка числа разных констант во входе из size байт: в типичной программе
+// одна новая константа приходится примерно на BYTES_PER_CONSTANT байт.
+// Пул сразу получает такую таблицу и не перестраивается по ходу разбора;
+// оценка ограничена, чтобы огромный вход не занимал память под пустые ячейки.
+std::size_t Lexer::expectedConstants(std::size_t size) {
+    return std::min<std::size_t>(size / BYTES_PER_CONSTANT, MAX_RESERVED_CONSTANTS);
+}
+
+// Открытие выходного файла
+void Lexer::openOutput(const std::string& outputFilename) {
+    ownOutput.reset(new OutputSink(outputFilename));
+    output = ownOutput.get();
+    if (!output->isOpen()) {
+        std::cerr << "Не удалось открыть выходной файл: " << outputFilename << std::endl;
+        hasError = true;
+    }
+}
+
+Lexer::~Lexer() {
+}
+
+// Переход к следующему символу во входных байтах
+void Lexer::nextChar() {
+    if (cursor < inputEnd) {
+        ++cursor;
+    }
+    if (cursor < inputEnd) {
+        currentChar = *cursor;
+    }
+    else {
+        currentChar = '\0';  // конец файла
+    }
+}
+
+// Переход сразу к символу target (как серия вызовов nextChar())
+void Lexer::advanceTo(const char* target) {
+    if (target <= cursor) return;
+    if (target < inputEnd) {
+        cursor = target;
+        currentChar = *cursor;
+    }
+    else {
+        cursor = inputEnd;
+        currentChar = '\0';
+    }
+}
+
+// Потоковый вход: переход к следующему окну, когда лексер дошёл до конца текущего.
+// Окно кончается на границе лексем (после пробельного символа или односимвольного
+// разделителя, см. StreamSource), поэтому сюда попадаем только между лексемами (из skipWhitespace).
+bool Lexer::refill() {
+    if (!streamSource.isOpen()) return false;
+    bool more = streamSource.next(static_cast<std::size_t>(cursor - inputBegin));
+    inputBegin = streamSource.begin();
+    baseOffset = streamSource.offset();
+    cursor = inputBegin;
+    inputEnd = streamSource.end();
+    currentChar = cursor < inputEnd ? *cursor : '\0';
+    scanner.reset(inputEnd);  // окно перезаписано - маски старых блоков не годятся
+    return more;
+}
+
+// Пропуск пробелов, табуляций и переводов строк (строки не считаются - их даёт индекс строк)
+void Lexer::skipWhitespace() {
+    for (;;) {
+        const char* stop = scanner.skipSpaces(cursor);
+        if (streamSource.isOpen()) {
+            lineCounter.scan(cursor, stop, currentOffset());  // индекса строк у потока нет
+        }
+        advanceTo(stop);
+        if (cursor < inputEnd || !refill()) return;  // окно потока кончилось - читаем следующее
+    }
+}
+
+// Строка и позиция по смещению: по индексу строк или, для потока, по счётчику строк
+SourceLocation Lexer::locate(std::size_t offset) const {
+    if (streamSource.isOpen()) {
+        return lineCounter.locate(offset, streamSource.atEnd(offset));
+    }
+    return lineIndex.locate(offset);
+}
+
+// Токен от startOffset до курсора (длина - число пройденных байтов)
+Token Lexer::makeToken(TokenType type, std::size_t startOffset, std::uint32_t id) const {
+    return Token(type, startOffset, static_cast<std::uint32_t>(currentOffset() - startOffset), id);
+}
+
+// Конец серии [start, stop), укороченной до наибольшей длины лексемы: более длинная
+// серия букв или цифр разбирается как несколько лексем
+const char* Lexer::limitLexeme(const char* start, const char* stop) {
+    return static_cast<std::size_t>(stop - start) > Token::MAX_LENGTH ? start + Token::MAX_LENGTH : stop;
+}
+
+// Токен ошибки: вид ошибки хранится в номере токена
+Token Lexer::makeError(LexError error, std::size_t startOffset) const {
+    return makeToken(TokenType::ERROR, startOffset, static_cast<std::uint32_t>(error));
+}
+
+// Разбор идентификатора или ключевого слова
+Token Lexer::parseIdentifier() {
+    const char* start = cursor; // начало лексемы во входных байтах
+    std::size_t startOffset = currentOffset(); // смещение начала во входных байтах
+
+    // Первый символ должен быть только буквой
+    if (!isLetterChar(currentChar)) {
+        nextChar();
+        return makeError(LexError::ID_BAD_START, startOffset);
+    }
+
+    // Находим конец серии букв
+    const char* stop = limitLexeme(start, scanner.skipLetters(cursor + 1));
+
+    // Если после букв идет цифра - это ошибка (идентификатор с цифрами)
+    if (stop < inputEnd && isDigitChar(*stop)) {
+        // Захватываем весь идентификатор с цифрами для сообщения об ошибке
+        advanceTo(limitLexeme(start, scanner.skipAlnum(stop)));
+        return makeError(LexError::ID_HAS_DIGITS, startOffset);
+    }
+
+    // Если после букв идет _ - это ошибка
+    if (stop < inputEnd && *stop == '_' && stop - start < static_cast<std::ptrdiff_t>(Token::MAX_LENGTH)) {
+        advanceTo(stop + 1);
+        return makeError(LexError::ID_HAS_UNDERSCORE, startOffset);
+    }
+
+    advanceTo(stop);
+
+    // Ключевое слово или обычный идентификатор - один хеш и одно сравнение
+    std::size_t length = static_cast<std::size_t>(cursor - start);
+    TokenType type = lookupKeyword(start, length);
+    if (type == TokenType::ID) {
+        // одинаковые имена - один номер
+        return makeToken(type, startOffset, static_cast<std::uint32_t>(names.insert(std::string_view(start, length)).first));
+    }
+    return makeToken(type, startOffset);
+}
+
+// Разбор числовой константы
+Token Lexer::parseNumber() {
+    const char* start = cursor; // начало числа во входных байтах
+    std::size_t startOffset = currentOffset(); // смещение начала во входных байтах
+
+    // Пропускаем все цифры, пока они идут подряд
+    advanceTo(limitLexeme(start, scanner.skipDigits(cursor)));
+
+    // Проверяем, что число не начинается с 0 (кроме самого 0)
+    if (cursor - start > 1 && *start == '0') {
+        return makeError(LexError::NUMBER_LEADING_ZERO, startOffset);
+    }
+
+    // Значение числа вычисляется сразу; до MAX_SAFE_DIGITS цифр переполнения быть не может,
+    // и проверка нужна только для более длинных чисел
+    std::int64_t value = 0;
+    const char* p = start;
+    if (cursor - start <= MAX_SAFE_DIGITS) {
+        for (; p < cursor; ++p) {
+            value = value * 10 + (*p - '0');
+        }
+    }
+    for (; p < cursor; ++p) {
+        int digit = *p - '0';
+        if (value > (INT64_MAX - digit) / 10) {
+            return makeError(LexError::NUMBER_OVERFLOW, startOffset);
+        }
+        value = value * 10 + digit;
+    }
+
+    return makeToken(TokenType::CONST, startOffset, constantPool.intern(value));  // одинаковые константы - один индекс
+}
+
+// Разбор операторов и разделителей по таблице переходов
+Token Lexer::parseOperator() {
+    std::size_t startOffset = currentOffset(); // смещение начала во входных байтах
+
+    OperatorState state = OperatorState::START;
+    for (;;) {
+        const OperatorTransition& step =
+            OPERATOR_DFA.step[static_cast<int>(state)][static_cast<int>(charClass(currentChar))];
+        if (step.consume) {
+            nextChar();
+        }
+        if (step.emit) {
+            if (step.type == TokenType::ERROR) {
+                return makeError(LexError::INVALID_CHAR, startOffset);
+            }
+            return makeToken(step.type, startOffset);
+        }
+        state = step.next;
+    }
+}
+
+// Разбор следующего токена: лексема - это байты [offset, offset + length),
+// место в тексте вычисляется по смещению.
+// Вид токена определяется по маскам блока; '\0', '_' и недопустимые символы
+// (их нет в масках) - по таблице классов.
+Token Lexer::scanToken() {
+    skipWhitespace();  // пропускаем пробелы
+
+    std::uint64_t bit;
+    const BlockMasks& masks = scanner.masksAt(cursor, bit);
+    if (masks.letter & bit) {
+        return parseIdentifier();  // идентификатор или ключевое слово
+    }
+    if (masks.digit & bit) {
+        return parseNumber();      // числовая константа
+    }
+    if (masks.op & bit) {
+        return parseOperator();    // оператор или разделитель
+    }
+
+    switch (charClass(currentChar)) {
+    case CharClass::END:         // конец файла
+        return Token(TokenType::END_OF_FILE, currentOffset());
+    case CharClass::UNDERSCORE:
+        return parseIdentifier();  // идентификатор с недопустимым началом
+    default:
+        return parseOperator();    // недопустимый символ
+    }
+}
+
+// Основной метод - получение следующего токена (16 байт, текст не копируется:
+// он доступен через lexeme(), место - через location())
+Token Lexer::getNextToken() {
+    return scanToken();
+}
+
+// Текст лексемы - вид на входные байты (у потокового входа - до следующего токена)
+std::string_view Lexer::lexeme(const Token& token) const {
+    return std::string_view(inputBegin + (token.offset() - baseOffset), token.length);
+}
+
+// Строка и позиция токена (у потокового входа - только последнего полученного)
+SourceLocation Lexer::location(const Token& token) const {
+    return locate(token.offset());
+}
+
+// Дописывание следующего токена в буфер: текст не копируется
+bool Lexer::scanInto(TokenBuffer& buffer) {
+    Token token = scanToken();
+    buffer.push(token);
+    return token.type() != TokenType::END_OF_FILE;
+}
+
+// Дописывание следующего токена в буфер без исходных байтов: текст копируется
+// прямо в буфер (без отдельной строки на токен), место вычисляется сразу
+bool Lexer::scanCopyInto(TokenBuffer& buffer) {
+    Token token = scanToken();
+    buffer.push(token, lexeme(token), locate(token.offset()));
+    return token.type() != TokenType::END_OF_FILE;
+}
+
+// Пустой буфер для readNext: с исходными байтами лексера, а для потокового входа -
+// с собственными копиями лексем (окно потока перезаписывается)
+TokenBuffer Lexer::newBuffer() const {
+    return streamSource.isOpen() ? TokenBuffer() : TokenBuffer(inputBegin, &lineIndex);
+}
+
+// Следующий токен - в конец буфера из newBuffer()
+bool Lexer::readNext(TokenBuffer& buffer) {
+    return streamSource.isOpen() ? scanCopyInto(buffer) : scanInto(buffer);
+}
+
+// Разбор всех оставшихся токенов в буфер (последний токен - END_OF_FILE).
+// При threadCount > 1 вход режется по переводам строк (лексемы не переходят через
+// строку), куски разбираются в отдельных потоках и склеиваются по порядку.
+// Токены хранят только смещения, поэтому куски не зависят друг от друга.
+// Результат совпадает с последовательными вызовами getNextToken().
+TokenBuffer Lexer::tokenize(unsigned threadCount) {
+    // Потоковый вход не хранится целиком - буфер держит копии лексем сам
+    if (streamSource.isOpen()) {
+        TokenBuffer buffer;
+        while (scanCopyInto(buffer)) {
+        }
+        return buffer;
+    }
+
+    // Последовательный лексер останавливается на первом '\0' - куски режем только до него
+    const char* limit = static_cast<const char*>(std::memchr(cursor, '\0', inputEnd - cursor));
+    if (!limit) limit = inputEnd;
+    std::size_t total = static_cast<std::size_t>(limit - cursor);
+
+    // Границы кусков: начало каждого куска - символ после '\n'
+    std::vector<const char*> bounds;
+    bounds.push_back(cursor);
+    if (threadCount > 1 && total >= 2 * MIN_CHUNK_SIZE) {
+        std::size_t chunks = std::min<std::size_t>(threadCount, total / MIN_CHUNK_SIZE);
+        for (std::size_t k = 1; k < chunks; k++) {
+            const char* target = std::max(cursor + total * k / chunks, bounds.back());
+            const char* newline = static_cast<const char*>(std::memchr(target, '\n', limit - target));
+            if (!newline || newline + 1 >= limit) break;
+            bounds.push_back(newline + 1);
+        }
+    }
+
+    TokenBuffer buffer(inputBegin, &lineIndex);
+    if (bounds.size() == 1) {
+        while (scanInto(buffer)) {
+        }
+        return buffer;
+    }
+
+    std::vector<TokenBuffer> chunks(bounds.size());
+    std::vector<ConstantPool> pools(bounds.size());  // константы каждого куска
+    std::vector<OpenHashSet> chunkNames(bounds.size());  // имена каждого куска
+    const char* stop = nullptr;  // где остановился лексер последнего куска
+
+    auto lexChunk = [&](std::size_t k) {
+        const bool last = (k + 1 == bounds.size());
+        Lexer chunkLexer(inputBegin, bounds[k], last ? inputEnd : bounds[k + 1]);
+        for (;;) {
+            Token token = chunkLexer.scanToken();
+            bool atEnd = (token.type() == TokenType::END_OF_FILE);
+            if (!atEnd || last) {  // END_OF_FILE нужен только от последнего куска
+                chunks[k].push(token);
+            }
+            if (atEnd) break;
+        }
+        pools[k] = std::move(chunkLexer.constantPool);
+        chunkNames[k] = std::move(chunkLexer.names);
+        if (last) stop = chunkLexer.cursor;
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t k = 1; k < bounds.size(); k++) {
+        workers.emplace_back(lexChunk, k);
+    }
+    lexChunk(0);  // первый кусок - в текущем потоке
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Склеиваем куски по порядку; константы и имена кусков переносятся в общий пул и таблицу
+    // имён в порядке первого появления - индексы и номера те же, что при последовательном разборе
+    std::size_t count = 0;
+    for (const TokenBuffer& chunk : chunks) count += chunk.size();
+    buffer.reserve(count);
+    for (std::size_t k = 0; k < chunks.size(); k++) {
+        std::vector<std::uint32_t> constRemap(pools[k].size());
+        for (std::size_t i = 0; i < pools[k].size(); i++) {
+            constRemap[i] = constantPool.intern(pools[k].value(i));
+        }
+        std::vector<std::uint32_t> symbolRemap(chunkNames[k].size());
+        for (std::size_t i = 0; i < chunkNames[k].size(); i++) {
+            symbolRemap[i] = static_cast<std::uint32_t>(names.insert(chunkNames[k].key(i)).first);
+        }
+        buffer.append(chunks[k], constRemap, symbolRemap);
+    }
+
+    // Сам лексер оказывается в конце входа
+    cursor = stop;
+    currentChar = '\0';
+    return buffer;
+}
+
+// Все токены входа с кэшем на диске (TokenCache): если в cachePath лежат токены
+// этого же входа, разбор пропускается, иначе вход разбирается tokenize() и кэш
+// перезаписывается. Потоковый вход, уже начатый разбор и вход меньше
+// TokenCache::MIN_SOURCE_SIZE не кэшируются.
+TokenBuffer Lexer::tokenizeCached(const std::string& cachePath, unsigned threadCount) {
+    if (streamSource.isOpen() || !inputFile.isOpen() || cursor != inputBegin || constantPool.size() > 0 || names.size() > 0
+        || static_cast<std::size_t>(inputEnd - inputBegin) < TokenCache::MIN_SOURCE_SIZE) {
+        return tokenize(threadCount);
+    }
+
+    TokenBuffer buffer(inputBegin, &lineIndex);
+    if (TokenCache::load(cachePath, inputBegin, inputEnd, buffer, constantPool, names)) {
+        // Лексер оказывается там же, где после разбора: на первом '\0' или в конце входа
+        const char* limit = static_cast<const char*>(std::memchr(cursor, '\0', inputEnd - cursor));
+        cursor = limit ? limit : inputEnd;
+        currentChar = '\0';
+        return buffer;
+    }
+
+    buffer = tokenize(threadCount);
+    TokenCache::save(cachePath, inputBegin, inputEnd, buffer, constantPool);
+    return buffer;
+}
+
+// Строка таблицы лексем для токена; для ошибки - ещё строка с сообщением
+static void writeTokenRow(OutputSink& out, const Token& token, SourceLocation where, std::string_view text) {
+    TokenType type = token.type();
+    if (type != TokenType::END_OF_FILE) {
+        out << where.line << " | " << where.position << " | "
+            << tokenTypeName(type) << " | " << text << '\n';
+    }
+    if (type == TokenType::ERROR) {
+        // Текст сообщения берётся из каталога по виду ошибки
+        writeLexError(out, where, text, token.error());
+        out << '\n';
+    }
+}
+
+// Вывод одного токена в таблицу; ошибки выводятся отдельной строкой,
+// остальные токены добавляются в хеш-таблицу
+void Lexer::reportToken(const Token& token, SourceLocation where, std::string_view text) {
+    writeTokenRow(*output, token, where, text);
+
+    if (token.type() == TokenType::ERROR) {
+        hasError = true;
+    }
+    else if (token.type() != TokenType::END_OF_FILE) {
+        // Добавляем токен в хеш-таблицу (кроме конца файла и ошибок)
+        hashTable.insert(token.type(), text);
+    }
+}
+
+// Главный метод анализа - обрабатывает весь файл (threadCount > 1 - параллельный разбор;
+// потоковый вход всегда разбирается последовательно)
+void Lexer::analyze(unsigned threadCount) {
+    if (!output || !output->isOpen()) return; // проверяем, что файл открыт
+
+    if (threadCount > 1 && !streamSource.isOpen()) {
+        // Токены разбираются параллельно, а выводятся и попадают в хеш-таблицу
+        // строго по порядку - индексы в таблице те же, что при последовательном разборе
+        report(tokenize(threadCount), threadCount);
+        return;
+    }
+
+    writeHeader();
+
+    Token token; // переменная для хранения текущего токена
+    // Основной цикл анализа - пока не достигнем конца файла
+    do {
+        token = getNextToken(); // получаем следующий токен
+        reportToken(token, location(token), lexeme(token));
+    } while (token.type() != TokenType::END_OF_FILE); // пока не конец файла
+
+    hashTable.writeTo(*output); // Выводим хеш-таблицу в файл
+}
+
+// Вывод результатов по уже разобранным токенам - тот же вывод, что у analyze().
+// Позволяет разобрать вход один раз и отдать те же токены парсеру.
+// При threadCount > 1 строки большой таблицы форматируются кусками в нескольких потоках
+// (за круг - threadCount кусков, память не зависит от длины входа) и пишутся по порядку;
+// хеш-таблица заполняется в этом потоке строго в порядке токенов.
+void Lexer::report(const TokenBuffer& tokens, unsigned threadCount) {
+    if (!output || !output->isOpen()) return; // проверяем, что файл открыт
+
+    writeHeader();
+    if (threadCount <= 1 || tokens.size() < 2 * REPORT_CHUNK_TOKENS) {
+        for (std::size_t i = 0; i < tokens.size(); i++) {
+            reportToken(tokens.at(i), tokens.location(i), tokens.lexeme(i));
+        }
+        hashTable.writeTo(*output); // Выводим хеш-таблицу в файл
+        return;
+    }
+
+    const std::size_t roundSize = threadCount * REPORT_CHUNK_TOKENS;
+    for (std::size_t roundStart = 0; roundStart < tokens.size(); roundStart += roundSize) {
+        const std::size_t roundEnd = std::min(tokens.size(), roundStart + roundSize);
+        std::vector<std::string> blocks((roundEnd - roundStart + REPORT_CHUNK_TOKENS - 1) / REPORT_CHUNK_TOKENS);
+
+        auto formatChunk = [&](std::size_t k) {
+            OutputSink block;  // вывод в память
+            std::size_t first = roundStart + k * REPORT_CHUNK_TOKENS;
+            std::size_t last = std::min(roundEnd, first + REPORT_CHUNK_TOKENS);
+            for (std::size_t i = first; i < last; i++) {
+                writeTokenRow(block, tokens.at(i), tokens.location(i), tokens.lexeme(i));
+            }
+            blocks[k] = block.takeText();
+        };
+
+        std::vector<std::thread> workers;
+        for (std::size_t k = 1; k < blocks.size(); k++) {
+            workers.emplace_back(formatChunk, k);
+        }
+        formatChunk(0);
+
+        for (std::size_t i = roundStart; i < roundEnd; i++) {
+            TokenType type = tokens.type(i);
+            if (type == TokenType::ERROR) {
+                hasError = true;
+            }
+            else if (type != TokenType::END_OF_FILE) {
+                hashTable.insert(type, tokens.text(i));
+            }
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        output->writeBlocks(blocks);
+    }
+
+    hashTable.writeTo(*output); // Выводим хеш-таблицу в файл
+}
+
+// Заголовок выходного файла
+void Lexer::writeHeader() {
+    *output << "Результаты лексического анализа:\n";
+    *output << "Строка | Позиция | Тип | Лексема\n";
+    *output << "---------------------------------\n";
+}
@@ -1,43 +1,100 @@
-#pragma once
-#ifndef LEXER_H
-#define LEXER_H
-
-#include "Token.h"
-#include "HashTable.h"
-#include <fstream>
-#include <string>
-
-class Lexer {
-private:
-    std::ifstream inputFile;   //    
-    std::ofstream outputFile;  //    
-
-    HashTable hashTable;       // -   
-
-    //   
-    char currentChar;          //   
-    int line;                 //  
-    int position;             //    
-    bool hasError;            //  
-
-    //   :
-    void skipWhitespace();              //     
-    void nextChar();                    //   
-    Token parseIdentifier();            //     
-    Token parseNumber();                //   
-    Token parseOperator();              //    
-    std::string tokenTypeToString(TokenType type); //    
-
-public:
-    //   
-    Lexer(const std::string& inputFilename, const std::string& outputFilename);
-    ~Lexer();
-
-    //  
-    Token getNextToken();      //   
-    bool hasErrors() const { return hasError; } //   
-    void analyze();            //   
-};
-
-#endif
-
+#pragma once
+#ifndef LEXER_H
+#define LEXER_H
+
+#include "Token.h"
+#include "CharScan.h"
+#include "HashTable.h"
+#include "OpenHashMap.h"
+#include "OutputSink.h"
+#include "SourceFile.h"
+#include "StreamSource.h"
+#include "LineIndex.h"
+#include "ConstantPool.h"
+#include "TokenBuffer.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Lexer {
+private:
+    SourceFile inputFile;      // входной файл, отображённый в память
+    LineIndex lineIndex;       // начала строк входного файла (строка и позиция по смещению)
+    StreamSource streamSource; // потоковый вход (если лексер читает из дескриптора)
+    LineCounter lineCounter;   // строки потокового входа (индекс строк для него не строится)
+    std::unique_ptr<OutputSink> ownOutput;  // выходной файл, открытый самим лексером
+    OutputSink* output;        // куда выводятся таблица лексем и хеш-таблица (nullptr - без вывода)
+
+    HashTable hashTable;       // хеш-таблица для хранения токенов
+    ConstantPool constantPool; // значения числовых констант
+    OpenHashSet names;         // имена (идентификаторы) в порядке первого появления: номер имени - id токена ID
+
+    // Текущее состояние анализатора
+    const char* inputBegin;    // начало входных байтов (для потока - начало окна)
+    std::size_t baseOffset;    // смещение inputBegin от начала входа (не 0 только для потока)
+    const char* cursor;        // указатель на текущий символ во входных байтах
+    const char* inputEnd;      // конец входных байтов
+    char currentChar;          // текущий обрабатываемый символ
+    BlockScanner scanner;      // маски классов символов по блокам входа (структурный проход)
+    bool hasError;            // флаг ошибки
+
+    // Приватные методы анализа:
+    void skipWhitespace();              // пропуск пробелов и переводов строк
+    void nextChar();                    // чтение следующего символа
+    void advanceTo(const char* target); // переход сразу к символу target
+    bool refill();                      // следующее окно потокового входа (false - вход кончился)
+    void openOutput(const std::string& outputFilename); // открытие выходного файла
+    std::size_t currentOffset() const { return baseOffset + static_cast<std::size_t>(cursor - inputBegin); } // смещение текущего символа
+    SourceLocation locate(std::size_t offset) const;  // строка и позиция по смещению
+    Token makeToken(TokenType type, std::size_t startOffset, std::uint32_t id = Token::NO_ID) const; // токен до курсора
+    Token makeError(LexError error, std::size_t startOffset) const; // токен ошибки до курсора
+    static const char* limitLexeme(const char* start, const char* stop); // серия не длиннее Token::MAX_LENGTH
+    Token parseIdentifier();            // разбор идентификатора или ключевого слова
+    Token parseNumber();                // разбор числовой константы
+    Token parseOperator();              // разбор операторов и разделителей
+    Token scanToken();                  // разбор следующего токена
+    bool scanInto(TokenBuffer& buffer); // разбор следующего токена в буфер (смещение и длина)
+    bool scanCopyInto(TokenBuffer& buffer); // разбор следующего токена в буфер с копией текста и места
+    void reportToken(const Token& token, SourceLocation where, std::string_view text); // вывод токена в таблицу и добавление в хеш-таблицу
+    void writeHeader();                   // заголовок таблицы лексем
+
+    // Лексер для куска входа [begin, end) при параллельном разборе
+    Lexer(const char* origin, const char* begin, const char* end);
+
+    static const std::size_t MIN_CHUNK_SIZE = 1 << 20;  // минимальный кусок на один поток (байт)
+    static const std::size_t REPORT_CHUNK_TOKENS = 1 << 16;  // токенов в куске таблицы при параллельном выводе
+    static const std::size_t BYTES_PER_CONSTANT = 32;          // байт входа на одну новую константу (оценка)
+    static const std::size_t MAX_RESERVED_CONSTANTS = 1 << 20; // наибольший запас пула констант заранее
+    static std::size_t expectedConstants(std::size_t size);    // ожидаемое число разных констант во входе
+    static const std::ptrdiff_t MAX_SAFE_DIGITS = 18;          // столько цифр всегда помещается в int64
+
+    friend class IncrementalLexer;  // перелексирует участки текста лексером для куска
+
+public:
+    // Конструктор и деструктор
+    Lexer(const std::string& inputFilename, const std::string& outputFilename); // пустое outputFilename - без вывода
+    Lexer(const std::string& inputFilename, OutputSink& sharedOutput); // вывод в общий выходной файл всех этапов
+    Lexer(const char* sourceBytes, std::size_t sourceSize); // исходный текст в памяти (не копируется)
+    Lexer(int inputFd, const std::string& outputFilename);  // потоковый вход из дескриптора (0 - stdin)
+    ~Lexer();
+
+    // Основные методы
+    Token getNextToken();      // получение следующего токена
+    std::string_view lexeme(const Token& token) const; // текст токена (у потока - только последнего)
+    SourceLocation location(const Token& token) const; // строка и позиция (у потока - только последнего)
+    TokenBuffer newBuffer() const;     // пустой буфер для токенов этого лексера (для readNext)
+    bool readNext(TokenBuffer& buffer); // следующий токен - в конец буфера (false - это END_OF_FILE)
+    TokenBuffer tokenize(unsigned threadCount = 1); // все оставшиеся токены (последний - END_OF_FILE)
+    TokenBuffer tokenizeCached(const std::string& cachePath, unsigned threadCount = 1); // то же через кэш на диске
+    bool hasErrors() const { return hasError; } // проверка наличия ошибок
+    bool isStream() const { return streamSource.isOpen(); } // потоковый вход (окно байтов перезаписывается)
+    const ConstantPool& constants() const { return constantPool; } // значения констант (по id токена CONST)
+    const OpenHashSet& symbols() const { return names; }           // имена (по id токена ID)
+    void analyze(unsigned threadCount = 1);     // основной метод анализа
+    void report(const TokenBuffer& tokens, unsigned threadCount = 1); // вывод результатов по готовым токенам
+};
+
+#endif
+
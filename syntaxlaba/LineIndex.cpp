@@ -0,0 +1,60 @@
+#include "LineIndex.h"
+#include "CharScan.h"
+#include <algorithm>
+
+LineIndex::LineIndex(const char* begin, const char* end)
+    : lineStarts(1, 0), size(static_cast<std::size_t>(end - begin)) {
+    // Новая строка начинается после каждого '\n' (поиск по 16 или 32 байта за раз)
+    forEachByte(begin, end, '\n', [&](const char* newline) {
+        lineStarts.push_back(static_cast<std::size_t>(newline - begin) + 1);
+    });
+}
+
+// Позиции считаются так же, как их всегда выводил лексер: на первой строке
+// первый символ имеет позицию 1, на остальных - 2 (перевод строки занимает позицию 1).
+// Конец файла стоит на позиции последнего символа, а после завершающего '\n' - на позиции 1.
+SourceLocation makeLocation(std::size_t row, std::size_t column, bool atEnd) {
+    if (atEnd) {
+        if (column == 0) {
+            return { static_cast<std::int64_t>(row) + 1, 1 };
+        }
+        column--;  // конец файла - на последнем символе
+    }
+    return { static_cast<std::int64_t>(row) + 1, static_cast<std::int64_t>(column) + (row > 0 ? 2 : 1) };
+}
+
+void LineIndex::update(std::size_t offset, std::size_t removed, const char* inserted, std::size_t insertedLength) {
+    // Строки, начинавшиеся внутри удалённого участка, исчезают
+    auto first = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    auto last = std::upper_bound(first, lineStarts.end(), offset + removed);
+
+    // Начала строк во вставленном тексте
+    std::vector<std::size_t> added;
+    forEachByte(inserted, inserted + insertedLength, '\n', [&](const char* newline) {
+        added.push_back(offset + static_cast<std::size_t>(newline - inserted) + 1);
+    });
+
+    // Строки после правки сдвигаются на разницу длин
+    for (auto it = last; it != lineStarts.end(); ++it) {
+        *it = *it - removed + insertedLength;
+    }
+    lineStarts.insert(lineStarts.erase(first, last), added.begin(), added.end());
+    size = size - removed + insertedLength;
+}
+
+SourceLocation LineIndex::locate(std::size_t offset) const {
+    bool atEnd = offset >= size;
+    if (atEnd) offset = size;
+
+    // Последняя строка, начинающаяся не позже offset
+    std::size_t row = static_cast<std::size_t>(
+        std::upper_bound(lineStarts.begin(), lineStarts.end(), offset) - lineStarts.begin()) - 1;
+    return makeLocation(row, offset - lineStarts[row], atEnd);
+}
+
+void LineCounter::scan(const char* begin, const char* end, std::size_t beginOffset) {
+    forEachByte(begin, end, '\n', [&](const char* newline) {
+        row++;
+        lineStart = beginOffset + static_cast<std::size_t>(newline - begin) + 1;
+    });
+}
@@ -1,56 +1,69 @@
-#ifndef PARSER_H
-#define PARSER_H
-
-#include "Lexer.h"
-#include "ParseTreeNode.h"
-#include <fstream>
-#include <string>
-#include <vector>
-
-class Parser {
-private:
-    //   
-    Lexer& lexer;                    //    
-    std::ofstream& outputFile;       //    
-    Token currentToken;              //   
-    bool hasError;                   //   
-    std::vector<std::string> errorMessages;  //    
-
-    //  
-    void checkSemicolon();                          //    
-    void advanceToken();                            //    
-    bool match(TokenType expectedType);             //   
-    std::string getTokenInfo();                     //    
-    void error(const std::string& message);         //  
-    void syncTo(const std::vector<TokenType>& syncTokens);  //   
-    void printTree(ParseTreeNode* node, int depth = 0);     //   
-    void printErrors();                             //   
-    std::string getExpressionValue(ParseTreeNode* exprNode); //   
-
-    //  
-    ParseTreeNode* parseProcedure();
-    ParseTreeNode* parseBegin();
-    ParseTreeNode* parseEnd();
-    ParseTreeNode* parseProcedureName();
-    ParseTreeNode* parseDescriptions();
-    ParseTreeNode* parseDescrList();
-    ParseTreeNode* parseDescr();
-    ParseTreeNode* parseVarList();
-    ParseTreeNode* parseType();
-    ParseTreeNode* parseOperators();
-    ParseTreeNode* parseOp();
-    ParseTreeNode* parseAssignment();
-    ParseTreeNode* parseIfStatement();
-    ParseTreeNode* parseExpr();
-    ParseTreeNode* parseSimpleExpr();
-    ParseTreeNode* parseCondition();
-    ParseTreeNode* parseRelationOperator();
-
-public:
-    //    
-    Parser(Lexer& lex, std::ofstream& out);  // 
-    bool parse();                            //    
-    bool hasErrors() const { return hasError; }  //   
-};
-
+#ifndef PARSER_H
+#define PARSER_H
+
+#include "Lexer.h"
+#include "TokenBuffer.h"
+#include "TokenStream.h"
+#include "ParseTreeNode.h"
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Parser {
+private:
+    // Основные компоненты парсера
+    std::unique_ptr<TokenStream> ownStream;  // Источник, созданный самим парсером
+    TokenStream& tokens;             // Источник токенов, из которого идёт разбор
+    BufferTokenStream* bufferTokens; // Тот же источник, если это буфер (иначе nullptr)
+    std::ostream& outputFile;        // Поток для результатов (файл, строка или пустой поток)
+    Token currentToken;              // текущий токен (16 байт; текст и место - у источника)
+    SourceLocation currentLocation;  // Строка и позиция текущего токена
+    bool hasError;                   // Флаг наличия ошибок
+    std::vector<std::string> errorMessages;  // Список сообщений об ошибках
+
+    // Вспомогательные методы
+    void checkSemicolon();                          // Проверка точки с запятой
+    void advanceToken();                            // Переход к следующему токену
+    std::string_view currentText();                 // Текст текущего токена
+    bool match(TokenType expectedType);             // Проверка типа токена
+    bool isIdentifierError();                       // Ошибочный идентификатор на месте id
+    std::string getTokenInfo();                     // Получение информации о токене
+    void error(const std::string& message);         // Обработка ошибки
+    void syncTo(const std::vector<TokenType>& syncTokens);  // Синхронизация после ошибки
+    void printTree(ParseTreeNode* node, int depth = 0);     // Вывод дерева разбора
+    void printErrors();                             // Вывод списка ошибок
+    std::string getExpressionValue(ParseTreeNode* exprNode); // Получение значения выражения
+
+    // Правила грамматики
+    ParseTreeNode* parseProcedure();
+    ParseTreeNode* parseBegin();
+    ParseTreeNode* parseEnd();
+    ParseTreeNode* parseProcedureName();
+    ParseTreeNode* parseDescriptions();
+    ParseTreeNode* parseDescrList();
+    ParseTreeNode* parseDescr();
+    ParseTreeNode* parseVarList();
+    ParseTreeNode* parseType();
+    ParseTreeNode* parseOperators();
+    ParseTreeNode* parseOp();
+    ParseTreeNode* parseAssignment();
+    ParseTreeNode* parseIfStatement();
+    ParseTreeNode* parseExpr();
+    ParseTreeNode* parseSimpleExpr();
+    ParseTreeNode* parseCondition();
+    ParseTreeNode* parseRelationOperator();
+
+public:
+    // Конструктор и публичные методы
+    Parser(Lexer& lex, std::ostream& out);  // Конструктор (токены берутся из лексера)
+    Parser(const TokenBuffer& tokenBuffer, std::ostream& out);  // Разбор готового буфера токенов
+    Parser(TokenStream& tokenStream, std::ostream& out);        // Разбор токенов из источника
+    bool parse();                            // Основной метод синтаксического анализа
+    bool hasErrors() const { return hasError; }  // Проверка наличия ошибок
+    const std::vector<std::string>& getErrors() const { return errorMessages; }  // Сообщения об ошибках
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "SourceFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SourceFile::SourceFile()
+    : data(nullptr), size(0), opened(false),
+#ifdef _WIN32
+    fileHandle(nullptr), mappingHandle(nullptr),
+#else
+    fd(-1),
+#endif
+    view(nullptr) {
+}
+
+SourceFile::SourceFile(const std::string& filename)
+    : data(nullptr), size(0), opened(false),
+#ifdef _WIN32
+    fileHandle(nullptr), mappingHandle(nullptr),
+#else
+    fd(-1),
+#endif
+    view(nullptr) {
+
+    if (mapFile(filename)) {
+        opened = true;
+        return;
+    }
+
+    // Отображение недоступно - читаем файл целиком в буфер
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return;
+    }
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = fallback.data();
+    size = fallback.size();
+    opened = true;
+}
+
+SourceFile::SourceFile(const char* bytes, std::size_t length)
+    : data(bytes), size(length), opened(true),
+#ifdef _WIN32
+    fileHandle(nullptr), mappingHandle(nullptr),
+#else
+    fd(-1),
+#endif
+    view(nullptr) {
+}
+
+SourceFile::~SourceFile() {
+    unmapFile();
+}
+
+#ifdef _WIN32
+
+// Отображение файла средствами WinAPI
+bool SourceFile::mapFile(const std::string& filename) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);  // пустой файл отобразить нельзя
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (address == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = mapping;
+    view = address;
+    data = static_cast<const char*>(address);
+    size = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+}
+
+void SourceFile::unmapFile() {
+    if (view) UnmapViewOfFile(view);
+    if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+    if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+    view = nullptr;
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+#else
+
+// Отображение файла средствами POSIX
+bool SourceFile::mapFile(const std::string& filename) {
+    int file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        ::close(file);  // каналы и пустые файлы читаются через буфер
+        return false;
+    }
+
+    void* address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    if (address == MAP_FAILED) {
+        ::close(file);
+        return false;
+    }
+    madvise(address, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    fd = file;
+    view = address;
+    data = static_cast<const char*>(address);
+    size = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void SourceFile::unmapFile() {
+    if (view) munmap(view, size);
+    if (fd >= 0) ::close(fd);
+    view = nullptr;
+    fd = -1;
+}
+
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#ifndef SOURCEFILE_H
+#define SOURCEFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Входной файл, отображённый в память (только для чтения).
+// Лексер сканирует байты напрямую указателем, без посимвольного чтения из потока.
+// Если отобразить файл нельзя (пустой файл, канал), содержимое читается в буфер целиком.
+// Источником могут быть и уже готовые байты в памяти - тогда они только используются.
+class SourceFile {
+private:
+    const char* data;          // начало байтов файла
+    std::size_t size;          // размер файла в байтах
+    bool opened;               // удалось ли открыть файл
+    std::string fallback;      // буфер на случай, если отображение недоступно
+
+#ifdef _WIN32
+    void* fileHandle;          // HANDLE файла
+    void* mappingHandle;       // HANDLE объекта отображения
+#else
+    int fd;                    // дескриптор файла
+#endif
+    void* view;                // адрес отображения (nullptr, если используется fallback)
+
+    bool mapFile(const std::string& filename);  // попытка отображения файла в память
+    void unmapFile();                           // освобождение отображения
+
+public:
+    SourceFile();                                  // пустой источник (не связан с файлом)
+    explicit SourceFile(const std::string& filename);
+    SourceFile(const char* bytes, std::size_t length);  // байты в памяти (не копируются)
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    bool isOpen() const { return opened; }             // открыт ли файл
+    const char* begin() const { return data; }         // первый байт
+    const char* end() const { return data + size; }    // байт за последним
+    std::size_t length() const { return size; }        // размер содержимого
+};
+
+#endif
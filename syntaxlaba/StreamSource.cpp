@@ -0,0 +1,101 @@
+#include "StreamSource.h"
+#include "OperatorDfa.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Можно ли резать окно сразу после символа класса c: пробельный символ не входит
+// в лексемы, а односимвольный разделитель (';', ',', скобки, '+', '-', '=', '>')
+// всегда кончает лексему - из любого состояния автомата операторов он либо
+// поглощается с выдачей токена, либо выдаёт предыдущий токен и затем поглощается
+constexpr bool endsLexeme(CharClass c) {
+    if (c == CharClass::SPACE) return true;
+    if (c < CharClass::COLON) return false;  // буквы, цифры, '_' и прочие разбираются вне автомата
+    const int start = static_cast<int>(OperatorState::START);
+    const OperatorTransition& first = OPERATOR_DFA.step[start][static_cast<int>(c)];
+    if (!first.consume || !first.emit) return false;
+    for (int state = 0; state < static_cast<int>(OperatorState::COUNT); state++) {
+        const OperatorTransition& step = OPERATOR_DFA.step[state][static_cast<int>(c)];
+        if (step.consume && !step.emit) return false;
+    }
+    return true;
+}
+
+struct BoundaryTable {
+    bool after[256];
+};
+
+constexpr BoundaryTable buildBoundaries() {
+    BoundaryTable table{};
+    for (int c = 0; c < 256; c++) table.after[c] = endsLexeme(CHAR_CLASSES.cls[c]);
+    return table;
+}
+
+constexpr BoundaryTable LEXEME_BOUNDARIES = buildBoundaries();
+
+}
+
+StreamSource::StreamSource()
+    : fd(-1), filled(0), windowSize(0), blockOffset(0), finished(true) {
+}
+
+StreamSource::StreamSource(int inputFd)
+    : fd(inputFd), block(BLOCK_SIZE), filled(0), windowSize(0), blockOffset(0), finished(inputFd < 0) {
+#ifdef _WIN32
+    if (fd >= 0) {
+        _setmode(fd, _O_BINARY);  // без замены \r\n на \n - позиции как у файла
+    }
+#endif
+}
+
+void StreamSource::readMore() {
+    while (!finished && filled < block.size()) {
+#ifdef _WIN32
+        int count = _read(fd, block.data() + filled, static_cast<unsigned>(block.size() - filled));
+#else
+        ssize_t count = ::read(fd, block.data() + filled, block.size() - filled);
+#endif
+        if (count <= 0) {
+            finished = true;  // конец потока или ошибка чтения
+        }
+        else {
+            filled += static_cast<std::size_t>(count);
+        }
+    }
+}
+
+bool StreamSource::next(std::size_t consumed) {
+    // Прочитанное лексером отбрасываем, начало незаконченной лексемы переносим в начало
+    if (consumed > 0) {
+        std::memmove(block.data(), block.data() + consumed, filled - consumed);
+        filled -= consumed;
+        blockOffset += consumed;
+    }
+
+    for (;;) {
+        readMore();
+
+        if (finished) {
+            windowSize = filled;  // весь остаток потока
+            return filled > 0;
+        }
+
+        // Окно заканчивается после последней границы лексем в буфере
+        std::size_t last = filled;
+        while (last > 0 && !LEXEME_BOUNDARIES.after[static_cast<unsigned char>(block[last - 1])]) {
+            last--;
+        }
+        if (last > 0) {
+            windowSize = last;
+            return true;
+        }
+        block.resize(block.size() * 2);  // лексема длиннее буфера - расширяем его
+    }
+}
@@ -1,41 +1,77 @@
-#pragma once
-#ifndef TOKEN_H
-#define TOKEN_H
-
-#include <string>
-
-//      ()
-enum class TokenType {
-    //   
-    PROCEDURE, BEGIN, END, VAR, INTEGER, IF, THEN, ELSE,
-
-    //  ( )   ()
-    ID, CONST,
-
-    // : , , 
-    ASSIGN, PLUS, MINUS, EQUAL, NOT_EQUAL, GREATER, LESS,
-
-    // :   , , , 
-    SEMICOLON, COLON, COMMA, LPAREN, RPAREN,
-
-    //     
-    END_OF_FILE, ERROR  //    
-};
-
-//      
-struct Token {
-    TokenType type;      //   (  )
-    std::string value;   //    (, "x", "10", "+")
-    int line;           //     
-    int position;       //   
-    std::string errorMessage;  //     
-
-    //     
-    Token(TokenType t = TokenType::END_OF_FILE,
-        const std::string& v = "",
-        int l = 1, int p = 1)
-        : type(t), value(v), line(l), position(p) {
-    }
-};
-
-#endif
+#pragma once
+#ifndef TOKEN_H
+#define TOKEN_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Перечисление всех возможных типов токенов (лексем); один байт - в токене
+// он занимает старший байт слова со смещением лексемы
+enum class TokenType : unsigned char {
+    // Ключевые слова языка
+    PROCEDURE, BEGIN, END, VAR, INTEGER, IF, THEN, ELSE,
+
+    // Идентификаторы (имена переменных) и константы (числа)
+    ID, CONST,
+
+    // Операторы: присваивание, арифметические, сравнения
+    ASSIGN, PLUS, MINUS, EQUAL, NOT_EQUAL, GREATER, LESS,
+
+    // Разделители: точка с запятой, двоеточие, запятая, скобки
+    SEMICOLON, COLON, COMMA, LPAREN, RPAREN,
+
+    // Служебные типы для управления анализом
+    END_OF_FILE, ERROR  // конец файла и ошибка
+};
+
+// Вид лексической ошибки (текст сообщения - в LexErrors.h).
+// Ошибки в идентификаторах идут последними: парсер узнаёт их одним сравнением.
+enum class LexError : unsigned char {
+    NONE,                  // нет ошибки
+    INVALID_CHAR,          // недопустимый символ
+    NUMBER_LEADING_ZERO,   // число начинается с 0
+    NUMBER_OVERFLOW,       // число не помещается в 64 бита
+    ID_BAD_START,          // идентификатор начинается не с буквы
+    ID_HAS_DIGITS,         // идентификатор содержит цифры
+    ID_HAS_UNDERSCORE      // идентификатор содержит '_'
+};
+
+static_assert(sizeof(TokenType) == 1 && sizeof(LexError) == 1, "тип и вид ошибки токена должны занимать по байту");
+
+// Токен - 16 байт без текста: смещение лексемы во входных байтах вместе с типом
+// (старший байт), длина лексемы и номер. Текст берётся из входных байтов по смещению
+// и длине, строка и позиция - по смещению через индекс строк (Lexer::lexeme и
+// Lexer::location, у буфера токенов - lexeme(i) и location(i)).
+// Номер (id): для ID - номер имени в таблице имён лексера, для CONST - индекс в пуле
+// констант, для ERROR - вид ошибки (LexError), у остальных - NO_ID.
+// Лексема не длиннее 4 ГБ - 1 байт: более длинная серия букв или цифр разбивается
+// лексером на несколько токенов.
+struct Token {
+    static const int TYPE_SHIFT = 56;                       // тип - в старшем байте word
+    static const std::uint64_t OFFSET_MASK = (std::uint64_t(1) << TYPE_SHIFT) - 1;  // смещения до 64 ПБ
+    static const std::uint32_t NO_ID = UINT32_MAX;          // у токена нет номера
+    static const std::uint32_t MAX_LENGTH = UINT32_MAX;     // наибольшая длина лексемы
+
+    std::uint64_t word;     // смещение начала лексемы (младшие 56 бит) и тип (старший байт)
+    std::uint32_t length;   // длина лексемы в байтах
+    std::uint32_t id;       // номер имени, индекс константы, вид ошибки или NO_ID
+
+    Token() : Token(TokenType::END_OF_FILE, 0) {}
+    Token(TokenType type, std::size_t offset, std::uint32_t lexemeLength = 0, std::uint32_t number = NO_ID)
+        : word(pack(type, offset)), length(lexemeLength), id(number) {
+    }
+
+    static std::uint64_t pack(TokenType type, std::size_t offset) {
+        return static_cast<std::uint64_t>(offset) | static_cast<std::uint64_t>(type) << TYPE_SHIFT;
+    }
+
+    TokenType type() const { return static_cast<TokenType>(word >> TYPE_SHIFT); }
+    std::size_t offset() const { return static_cast<std::size_t>(word & OFFSET_MASK); }
+    LexError error() const { return type() == TokenType::ERROR ? static_cast<LexError>(id) : LexError::NONE; }
+    std::int64_t constIndex() const { return type() == TokenType::CONST ? static_cast<std::int64_t>(id) : -1; }
+    std::int64_t symbol() const { return type() == TokenType::ID ? static_cast<std::int64_t>(id) : -1; }
+};
+
+static_assert(sizeof(Token) == 16, "токен должен занимать 16 байт");
+
+#endif
@@ -0,0 +1,54 @@
+#include "TokenBuffer.h"
+
+void TokenBuffer::push(const Token& token, std::string_view text, SourceLocation where) {
+    push(token);
+    textStarts.push_back(ownText.size());
+    ownText.append(text.data(), text.size());
+    locations.push_back(where);
+}
+
+void TokenBuffer::append(const TokenBuffer& other, const std::vector<std::uint32_t>& constRemap,
+    const std::vector<std::uint32_t>& symbolRemap) {
+    words.insert(words.end(), other.words.begin(), other.words.end());
+    lengths.insert(lengths.end(), other.lengths.begin(), other.lengths.end());
+
+    ids.reserve(ids.size() + other.ids.size());
+    for (std::size_t i = 0; i < other.size(); i++) {
+        std::uint32_t id = other.ids[i];
+        TokenType type = other.type(i);
+        const std::vector<std::uint32_t>* remap = type == TokenType::ID ? &symbolRemap
+            : type == TokenType::CONST ? &constRemap : nullptr;
+        ids.push_back(remap && !remap->empty() ? (*remap)[id] : id);
+    }
+}
+
+void TokenBuffer::splice(std::size_t first, std::size_t count, const TokenBuffer& replacement,
+    std::ptrdiff_t offsetShift) {
+    std::size_t last = first + count;
+    for (std::size_t i = last; i < words.size(); i++) {
+        std::size_t shifted = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offset(i)) + offsetShift);
+        words[i] = Token::pack(type(i), shifted);
+    }
+
+    words.erase(words.begin() + first, words.begin() + last);
+    words.insert(words.begin() + first, replacement.words.begin(), replacement.words.end());
+    lengths.erase(lengths.begin() + first, lengths.begin() + last);
+    lengths.insert(lengths.begin() + first, replacement.lengths.begin(), replacement.lengths.end());
+    ids.erase(ids.begin() + first, ids.begin() + last);
+    ids.insert(ids.begin() + first, replacement.ids.begin(), replacement.ids.end());
+}
+
+void TokenBuffer::reserve(std::size_t count) {
+    words.reserve(count);
+    lengths.reserve(count);
+    ids.reserve(count);
+}
+
+void TokenBuffer::clear() {
+    words.clear();
+    lengths.clear();
+    ids.clear();
+    ownText.clear();
+    textStarts.clear();
+    locations.clear();
+}
@@ -1,60 +1,62 @@
-#include "Lexer.h"
-#include "Parser.h"
-#include <iostream>
-#include <windows.h>
-#include <fstream>
-
-int main() {
-    SetConsoleOutputCP(1251);
-
-    std::string inputFile = "input.txt";
-    std::string outputFile = "output.txt";
-
-    std::cout << " ..." << std::endl;
-
-    //   
-    std::ofstream clearFile(outputFile);
-    clearFile.close();
-
-    // ===   ===
-    std::cout << " ..." << std::endl;
-    Lexer lexer1(inputFile, outputFile);  //   lexer1
-    lexer1.analyze();
-
-    if (lexer1.hasErrors()) {
-        std::cout << "    ." << std::endl;
-    }
-    else {
-        std::cout << "   ." << std::endl;
-    }
-
-    // ===   ===  
-    std::cout << " ..." << std::endl;
-
-    std::ofstream outFile(outputFile, std::ios::app);
-    if (!outFile.is_open()) {
-        std::cerr << "      " << std::endl;
-        return 1;
-    }
-
-    outFile << "\n" << std::string(50, '=') << std::endl;
-    outFile << " " << std::endl;
-    outFile << std::string(50, '=') << std::endl;
-
-    //      
-    Lexer parserLexer(inputFile, "temp.txt");
-    Parser parser(parserLexer, outFile);
-    bool parseSuccess = parser.parse();
-
-    outFile.close();
-
-    if (parseSuccess && !lexer1.hasErrors()) {
-        std::cout << "  !" << std::endl;
-    }
-    else {
-        std::cout << "   ." << std::endl;
-    }
-
-    system("pause");
-    return (parseSuccess && !lexer1.hasErrors()) ? 0 : 1;
+#include "Lexer.h"
+#include "Parser.h"
+#include <iostream>
+#include <thread>
+#include <windows.h>
+#include <ostream>
+
+int main() {
+    SetConsoleOutputCP(1251);
+
+    std::string inputFile = "input.txt";
+    std::string outputFile = "output.txt";
+
+    std::cout << "Запуск анализатора..." << std::endl;
+
+    // Один выходной файл на все этапы: лексер, парсер и семантический анализатор пишут
+    // в общий буфер, файл создаётся заново
+    OutputSink output(outputFile);
+    if (!output.isOpen()) {
+        std::cerr << "Не удалось открыть выходной файл: " << outputFile << std::endl;
+        return 1;
+    }
+    std::ostream outFile(&output);  // тот же буфер для вывода через std::ostream
+
+    // === ЛЕКСИЧЕСКИЙ АНАЛИЗ ===
+    std::cout << "Лексический анализ..." << std::endl;
+    // Вход разбирается один раз: те же токены идут в таблицу лексем и в парсер
+    Lexer lexer1(inputFile, output);  // переименовал в lexer1
+    // Большие файлы разбираются параллельно; токены неизменного входа от 1 МБ - из кэша input.txt.tok
+    unsigned threads = std::thread::hardware_concurrency();
+    TokenBuffer tokens = lexer1.tokenizeCached(inputFile + ".tok", threads);
+    lexer1.report(tokens, threads);
+
+    if (lexer1.hasErrors()) {
+        std::cout << "Лексический анализ завершен с ошибками." << std::endl;
+    }
+    else {
+        std::cout << "Лексический анализ завершен успешно." << std::endl;
+    }
+
+    // === СИНТАКСИЧЕСКИЙ АНАЛИЗ ===  
+    std::cout << "Синтаксический анализ..." << std::endl;
+
+    outFile << "\n" << std::string(50, '=') << std::endl;
+    outFile << "СИНТАКСИЧЕСКИЙ АНАЛИЗ" << std::endl;
+    outFile << std::string(50, '=') << std::endl;
+
+    // Парсер идёт по уже разобранным токенам
+    Parser parser(tokens, outFile);
+    bool parseSuccess = parser.parse();
+
+    if (parseSuccess && !lexer1.hasErrors()) {
+        std::cout << "Анализ завершен успешно!" << std::endl;
+    }
+    else {
+        std::cout << "Анализ завершен с ошибками." << std::endl;
+    }
+
+    output.flush();  // результаты - в файл до паузы
+    system("pause");
+    return (parseSuccess && !lexer1.hasErrors()) ? 0 : 1;
 }
\ No newline at end of file